@@ -53,6 +53,31 @@ extern "C"
       VWExample** example_handle_list, size_t example_handle_list_length,
       VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
 
+  // Batch variants of the above, one call for many examples so that the crossing and the per call setup are paid once
+  // per batch. Predictions stay in the example objects like in the single example variants. Processing stops at the
+  // first example that fails and the error is reported for the whole batch.
+  VW_DLL_PUBLIC VWStatus vw_workspace_learn_batch_legacy(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, size_t example_handle_list_length,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+  VW_DLL_PUBLIC VWStatus vw_workspace_predict_batch_legacy(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, size_t example_handle_list_length,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+
+  // The multiline groups are laid out one after the other in example_handle_list, group_lengths holds the number of
+  // examples of each of the group_count groups.
+  VW_DLL_PUBLIC VWStatus vw_workspace_learn_multiline_batch_legacy(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, const size_t* group_lengths, size_t group_count,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+  VW_DLL_PUBLIC VWStatus vw_workspace_predict_multiline_batch_legacy(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, const size_t* group_lengths, size_t group_count,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+
+  // Predicts a batch of single line examples with a scalar prediction type and writes the predictions to the caller
+  // provided predictions buffer, which must hold example_handle_list_length floats.
+  VW_DLL_PUBLIC VWStatus vw_workspace_predict_batch_scalar(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, size_t example_handle_list_length, float* predictions,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+
   // Finish does not do the release operation to allow reuse - the user must explicitly dealloc the object.
   VW_DLL_PUBLIC VWStatus vw_workspace_finish_example(
       VWWorkspace* workspace_handle, VWExample* example_handle, VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
@@ -60,6 +85,12 @@ extern "C"
       VWExample** example_handle_list, size_t example_handle_list_length,
       VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
 
+  // Finishes each example of a batch of single line examples with vw_workspace_finish_example, stopping at the first
+  // failure.
+  VW_DLL_PUBLIC VWStatus vw_workspace_finish_example_batch(VWWorkspace* workspace_handle,
+      VWExample** example_handle_list, size_t example_handle_list_length,
+      VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
+
   VW_DLL_PUBLIC VWStatus vw_workspace_end_pass(
       VWWorkspace* workspace_handle, VWErrorInfo* err_info_container) VW_API_NOEXCEPT;
 
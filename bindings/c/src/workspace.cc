@@ -88,6 +88,39 @@ VW_DLL_PUBLIC VWStatus vw_workspace_predict_multiline_legacy(VWWorkspace* worksp
   return VW_not_implemented;
 }
 
+VW_DLL_PUBLIC VWStatus vw_workspace_learn_batch_legacy(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, size_t example_handle_list_length, VWErrorInfo* err_info_container) noexcept
+{
+  return VW_not_implemented;
+}
+
+VW_DLL_PUBLIC VWStatus vw_workspace_predict_batch_legacy(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, size_t example_handle_list_length, VWErrorInfo* err_info_container) noexcept
+{
+  return VW_not_implemented;
+}
+
+VW_DLL_PUBLIC VWStatus vw_workspace_learn_multiline_batch_legacy(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, const size_t* group_lengths, size_t group_count,
+    VWErrorInfo* err_info_container) noexcept
+{
+  return VW_not_implemented;
+}
+
+VW_DLL_PUBLIC VWStatus vw_workspace_predict_multiline_batch_legacy(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, const size_t* group_lengths, size_t group_count,
+    VWErrorInfo* err_info_container) noexcept
+{
+  return VW_not_implemented;
+}
+
+VW_DLL_PUBLIC VWStatus vw_workspace_predict_batch_scalar(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, size_t example_handle_list_length, float* predictions,
+    VWErrorInfo* err_info_container) noexcept
+{
+  return VW_not_implemented;
+}
+
 VW_DLL_PUBLIC VWStatus vw_workspace_finish_example(
     VWWorkspace* workspace_handle, VWExample* example_handle, VWErrorInfo* err_info_container) noexcept
 {
@@ -100,6 +133,17 @@ VW_DLL_PUBLIC VWStatus vw_workspace_finish_example_multiline(VWWorkspace* worksp
   return VW_not_implemented;
 }
 
+VW_DLL_PUBLIC VWStatus vw_workspace_finish_example_batch(VWWorkspace* workspace_handle,
+    VWExample** example_handle_list, size_t example_handle_list_length, VWErrorInfo* err_info_container) noexcept
+{
+  for (size_t i = 0; i < example_handle_list_length; i++)
+  {
+    const auto status = vw_workspace_finish_example(workspace_handle, example_handle_list[i], err_info_container);
+    if (status != VW_success) { return status; }
+  }
+  return VW_success;
+}
+
 VW_DLL_PUBLIC VWStatus vw_workspace_end_pass(VWWorkspace* workspace_handle, VWErrorInfo* err_info_container) noexcept
 {
   return VW_not_implemented;
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "allreduce.h"
+
+static void add_float(float& a, const float& b) { a += b; }
+
+// Sums 2^bits floats over in-process nodes that share an AllReduceSync, as with several vw instances in one process.
+// The benchmark thread is the first node.
+static void bench_threads_all_reduce(benchmark::State& state)
+{
+  const auto total = static_cast<size_t>(state.range(0));
+  const size_t n = size_t(1) << state.range(1);
+
+  AllReduceThreads root(total, 0, true);
+  std::vector<std::unique_ptr<AllReduceThreads>> nodes;
+  for (size_t node = 1; node < total; node++) { nodes.emplace_back(new AllReduceThreads(&root, total, node, true)); }
+
+  // One extra element of the buffer tells the other nodes whether another round follows.
+  std::vector<std::thread> threads;
+  for (auto& node : nodes)
+  {
+    AllReduceThreads* all_reduce = node.get();
+    threads.emplace_back([all_reduce, n] {
+      std::vector<float> buffer(n + 1);
+      do
+      {
+        buffer[n] = 0.f;
+        all_reduce->all_reduce<float, add_float>(buffer.data(), n + 1);
+      } while (buffer[n] != 0.f);
+    });
+  }
+
+  std::vector<float> buffer(n + 1);
+  for (auto _ : state)
+  {
+    buffer[n] = 1.f;
+    root.all_reduce<float, add_float>(buffer.data(), n + 1);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  buffer[n] = 0.f;
+  root.all_reduce<float, add_float>(buffer.data(), n + 1);
+  for (auto& thread : threads) { thread.join(); }
+
+  state.SetBytesProcessed(state.iterations() * n * sizeof(float));
+}
+
+BENCHMARK(bench_threads_all_reduce)
+    ->Args({2, 10})
+    ->Args({4, 10})
+    ->Args({4, 16})
+    ->Args({4, 20})
+    ->Args({8, 20})
+    ->UseRealTime();
+
+#ifndef _WIN32
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+
+#  include "spanning_tree.h"
+
+// Sums 2^bits floats over nodes that run in separate processes and talk over loopback, with an in-process span server
+// as coordinator like a cluster job. The first node is the benchmark process, the others are forked. One extra element
+// of the buffer tells the forked nodes whether another round follows.
+static void bench_socket_all_reduce(benchmark::State& state, AllReduceAlgorithm algorithm)
+{
+  static size_t unique_id = 0;
+  ++unique_id;
+  const auto total = static_cast<size_t>(state.range(0));
+  const size_t n = size_t(1) << state.range(1);
+
+  VW::SpanningTree span_server(0, true);
+  span_server.Start();
+  const int port = span_server.BoundPort();
+
+  std::vector<pid_t> children;
+  for (size_t node = 1; node < total; node++)
+  {
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+      try
+      {
+        AllReduceSockets all_reduce("localhost", port, unique_id, total, node, true, algorithm);
+        std::vector<float> buffer(n + 1);
+        do
+        {
+          buffer[n] = 0.f;
+          all_reduce.all_reduce<float, add_float>(buffer.data(), n + 1);
+        } while (buffer[n] != 0.f);
+      }
+      catch (...)
+      {
+        _exit(1);
+      }
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+
+  AllReduceSockets all_reduce("localhost", port, unique_id, total, 0, true, algorithm);
+  std::vector<float> buffer(n + 1);
+  // The first round connects the nodes.
+  buffer[n] = 1.f;
+  all_reduce.all_reduce<float, add_float>(buffer.data(), n + 1);
+  for (auto _ : state)
+  {
+    buffer[n] = 1.f;
+    all_reduce.all_reduce<float, add_float>(buffer.data(), n + 1);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  buffer[n] = 0.f;
+  all_reduce.all_reduce<float, add_float>(buffer.data(), n + 1);
+  for (pid_t pid : children) { waitpid(pid, nullptr, 0); }
+
+  state.SetBytesProcessed(state.iterations() * n * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(bench_socket_all_reduce, tree, AllReduceAlgorithm::Tree)
+    ->Args({2, 16})
+    ->Args({4, 16})
+    ->Args({4, 20})
+    ->Args({4, 24})
+    ->Args({8, 24})
+    ->UseRealTime();
+BENCHMARK_CAPTURE(bench_socket_all_reduce, ring, AllReduceAlgorithm::Ring)
+    ->Args({2, 16})
+    ->Args({4, 16})
+    ->Args({4, 20})
+    ->Args({4, 24})
+    ->Args({8, 24})
+    ->UseRealTime();
+#endif
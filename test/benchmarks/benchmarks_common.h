@@ -18,6 +18,27 @@ auto get_x_string_fts = [](int feature_size) {
   return s;
 };
 
+auto get_x_string_value_fts = [](int feature_size) {
+  std::stringstream ss;
+  ss << "1:1:0.5 | ";
+  for (size_t i = 0; i < feature_size; i++)
+  { ss << "bigfeaturename" + std::to_string(i) + ":value" + std::to_string(i) + " "; }
+  std::string s = ss.str();
+  return s;
+};
+
+auto get_x_string_fts_namespaces = [](int feature_size, size_t namespaces) {
+  std::stringstream ss;
+  ss << "1:1:0.5 ";
+  for (size_t n = 0; n < namespaces; n++)
+  {
+    ss << "|namespace" + std::to_string(n) + ":0.5 ";
+    for (size_t i = 0; i < feature_size; i++) { ss << "a_much_longer_feature_name_" + std::to_string(i) + ":0.25 "; }
+  }
+  std::string s = ss.str();
+  return s;
+};
+
 auto get_x_string_fts_no_label = [](int feature_size, size_t action_index = 0) {
   std::stringstream ss;
   ss << " | ";
@@ -46,4 +67,24 @@ auto get_x_string_fts_multi_ex = [](int feature_size, size_t actions, bool share
     ss << std::endl;
   }
   return ss.str();
-};
\ No newline at end of file
+};
+
+auto get_dsjson_event = [](size_t actions, int feature_size) {
+  std::stringstream ss;
+  ss << R"({"_label_cost":-1,"_label_probability":0.5,"_label_Action":1,"_labelIndex":0,)";
+  ss << R"("Timestamp":"2021-02-04T16:31:29.2460000Z","Version":"1","EventId":"event",)";
+  ss << R"("a":[)";
+  for (size_t i = 0; i < actions; i++) { ss << (i == 0 ? "" : ",") << i + 1; }
+  ss << R"(],"c":{"User":{"id":"user","major":"engineering","hobby":"hiking"},"_multi":[)";
+  for (size_t i = 0; i < actions; i++)
+  {
+    ss << (i == 0 ? "{" : ",{") << R"("Action":{"id":"action)" << i << R"("},"Features":{)";
+    for (int j = 0; j < feature_size; j++)
+    { ss << (j == 0 ? "" : ",") << "\"f" << j << R"(":)" << (j % 2 == 0 ? "\"value\"" : "0.5"); }
+    ss << "}}";
+  }
+  ss << R"(]},"p":[)";
+  for (size_t i = 0; i < actions; i++) { ss << (i == 0 ? "" : ",") << 1.f / actions; }
+  ss << R"(],"VWState":{"m":"model/id"}})";
+  return ss.str();
+};
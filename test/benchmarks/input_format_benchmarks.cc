@@ -12,11 +12,12 @@
 
 #include "cache.h"
 #include "parser.h"
+#include "parse_example_json.h"
 #include "io/io_adapter.h"
 #include "vw.h"
 #include "benchmarks_common.h"
 
-std::shared_ptr<std::vector<char>> get_cache_buffer(const std::string& es)
+std::shared_ptr<std::vector<char>> get_cache_buffer(const std::string& es, bool columnar = false)
 {
   auto vw = VW::initialize("--cb 2 --quiet");
   auto buffer = std::make_shared<std::vector<char>>();
@@ -30,7 +31,15 @@ std::shared_ptr<std::vector<char>> get_cache_buffer(const std::string& es)
   if (vw->example_parser->write_cache)
   {
     vw->example_parser->lbl_parser.cache_label(&ae->l, ae->_reduction_features, *(vw->example_parser->output));
-    cache_features(*(vw->example_parser->output), ae, vw->parse_mask);
+    if (columnar)
+    {
+      std::vector<uint32_t> deltas;
+      cache_columnar_features(*(vw->example_parser->output), ae, vw->parse_mask, deltas);
+    }
+    else
+    {
+      cache_features(*(vw->example_parser->output), ae, vw->parse_mask);
+    }
   }
   vw->example_parser->output->flush();
   VW::finish_example(*vw, *ae);
@@ -86,6 +95,31 @@ static void bench_cache_io_buf_collections(benchmark::State& state, ExtraArgs&&.
   examples.delete_v();
 }
 
+// Decoding of the namespace layout used by block caches.
+template <class... ExtraArgs>
+static void bench_columnar_cache_io_buf(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  std::string res[sizeof...(extra_args)] = {extra_args...};
+  auto example_string = res[0];
+
+  auto buffer = get_cache_buffer(example_string, true);
+  auto vw = VW::initialize("--cb 2 --quiet");
+
+  auto examples = v_init<example*>();
+  examples.push_back(&VW::get_unused_example(vw));
+
+  vw->example_parser->input = VW::make_unique<io_buf>();
+
+  for (auto _ : state)
+  {
+    vw->example_parser->input->add_file(VW::io::create_buffer_view(buffer->data(), buffer->size()));
+    read_cached_example(*vw, *vw->example_parser, *vw->example_parser->input, examples[0], true);
+    VW::empty_example(*vw, *examples[0]);
+    benchmark::ClobberMemory();
+  }
+  examples.delete_v();
+}
+
 template <class... ExtraArgs>
 static void bench_text_io_buf(benchmark::State& state, ExtraArgs&&... extra_args)
 {
@@ -108,6 +142,30 @@ static void bench_text_io_buf(benchmark::State& state, ExtraArgs&&... extra_args
   examples.delete_v();
 }
 
+template <class... ExtraArgs>
+static void bench_dsjson(benchmark::State& state, ExtraArgs&&... extra_args)
+{
+  std::string res[sizeof...(extra_args)] = {extra_args...};
+  auto example_string = res[0];
+
+  auto vw = VW::initialize("--cb_explore_adf --dsjson --chain_hash --quiet");
+  auto examples = v_init<example*>();
+
+  for (auto _ : state)
+  {
+    examples.push_back(&VW::get_unused_example(vw));
+    // The parser works in place, so it parses a null terminated copy of the line.
+    std::vector<char> line(example_string.begin(), example_string.end());
+    line.push_back('\0');
+    DecisionServiceInteraction interaction;
+    VW::read_line_decision_service_json<false>(*vw, examples, line.data(), example_string.size(), false,
+        reinterpret_cast<VW::example_factory_t>(&VW::get_unused_example), vw, &interaction);
+    VW::return_multiple_example(*vw, examples);
+    benchmark::ClobberMemory();
+  }
+  examples.delete_v();
+}
+
 static void benchmark_example_reuse(benchmark::State& state)
 {
   std::string example_string =
@@ -133,9 +191,16 @@ static void benchmark_example_reuse(benchmark::State& state)
 }
 
 BENCHMARK_CAPTURE(bench_cache_io_buf, 120_string_fts, get_x_string_fts(120));
+BENCHMARK_CAPTURE(bench_columnar_cache_io_buf, 120_string_fts, get_x_string_fts(120));
 BENCHMARK_CAPTURE(bench_text_io_buf, 120_string_fts, get_x_string_fts(120));
 
 BENCHMARK_CAPTURE(bench_cache_io_buf, 120_num_fts, get_x_numerical_fts(120));
+BENCHMARK_CAPTURE(bench_columnar_cache_io_buf, 120_num_fts, get_x_numerical_fts(120));
 BENCHMARK_CAPTURE(bench_text_io_buf, 120_num_fts, get_x_numerical_fts(120));
 
+BENCHMARK_CAPTURE(bench_text_io_buf, 120_string_value_fts, get_x_string_value_fts(120));
+BENCHMARK_CAPTURE(bench_text_io_buf, 8x40_long_name_fts, get_x_string_fts_namespaces(40, 8));
+
+BENCHMARK_CAPTURE(bench_dsjson, 8_actions_20_fts, get_dsjson_event(8, 20));
+
 BENCHMARK(benchmark_example_reuse);
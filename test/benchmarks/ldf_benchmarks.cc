@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "vw.h"
+
+// Predicts a single cb_adf example with state.range(0) actions of 20 features each, crossed with 8 shared features.
+static void bench_cb_adf_predict(benchmark::State& state, const std::string& extra_args)
+{
+  const auto num_actions = static_cast<size_t>(state.range(0));
+  auto& all = *VW::initialize("--cb_adf -q UA --quiet" + extra_args, nullptr, false, nullptr, nullptr);
+
+  multi_ex examples;
+  examples.push_back(VW::read_example(all, std::string("shared |U u1 u2 u3 u4 u5 u6 u7 u8")));
+  for (size_t i = 0; i < num_actions; i++)
+  {
+    std::string action = "|A";
+    for (size_t j = 0; j < 20; j++) { action += " a" + std::to_string(i) + "_" + std::to_string(j); }
+    examples.push_back(VW::read_example(all, action));
+  }
+
+  for (auto _ : state)
+  {
+    all.predict(examples);
+    benchmark::DoNotOptimize(examples[0]->pred.a_s.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_actions);
+
+  all.finish_example(examples);
+  VW::finish(all);
+}
+
+BENCHMARK_CAPTURE(bench_cb_adf_predict, 1_thread, std::string())->Arg(16)->Arg(256)->Arg(1024)->UseRealTime();
+BENCHMARK_CAPTURE(bench_cb_adf_predict, 4_threads, std::string(" --ldf_predict_threads 4"))
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(1024)
+    ->UseRealTime();
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include <thread>
+#include <vector>
+
+#include "queue.h"
+
+// Moves a fixed number of items from a producer thread to the benchmark thread through the queue.
+template <typename QueueT>
+static void bench_queue_throughput(benchmark::State& state)
+{
+  const auto ring_size = static_cast<size_t>(state.range(0));
+  const size_t num_items = 1 << 16;
+  std::vector<int> items(num_items);
+
+  for (auto _ : state)
+  {
+    QueueT queue{ring_size};
+    std::thread producer([&] {
+      for (auto& item : items) { queue.push(&item); }
+      queue.set_done();
+    });
+
+    size_t count = 0;
+    while (queue.pop() != nullptr) { count++; }
+    producer.join();
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * num_items);
+}
+
+BENCHMARK_TEMPLATE(bench_queue_throughput, VW::ptr_queue<int>)->Arg(16)->Arg(256)->Arg(4096)->UseRealTime();
+BENCHMARK_TEMPLATE(bench_queue_throughput, VW::spsc_ptr_queue<int>)->Arg(16)->Arg(256)->Arg(4096)->UseRealTime();
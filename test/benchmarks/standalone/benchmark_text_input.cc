@@ -32,9 +32,9 @@ static void bench_text(benchmark::State& state, ExtraArgs&&... extra_args)
   examples.delete_v();
 }
 
-static void benchmark_learn_simple(benchmark::State& state, std::string example_string)
+static void benchmark_learn_simple(benchmark::State& state, std::string example_string, std::string extra_args = "")
 {
-  auto vw = VW::initialize("--quiet", nullptr, false, nullptr, nullptr);
+  auto vw = VW::initialize("--quiet" + extra_args, nullptr, false, nullptr, nullptr);
 
   auto* example = VW::read_example(*vw, example_string);
   VW::setup_example(*vw, example);
@@ -47,6 +47,20 @@ static void benchmark_learn_simple(benchmark::State& state, std::string example_
   vw->finish_example(*example);
 }
 
+static void benchmark_oaa_predict(benchmark::State& state, std::string example_string)
+{
+  auto vw = VW::initialize("--quiet --oaa " + std::to_string(state.range(0)), nullptr, false, nullptr, nullptr);
+
+  auto* example = VW::read_example(*vw, example_string);
+
+  for (auto _ : state)
+  {
+    vw->predict(*example);
+    benchmark::ClobberMemory();
+  }
+  vw->finish_example(*example);
+}
+
 static void benchmark_cb_adf_learn(benchmark::State& state)
 {
   auto vw = VW::initialize("--cb_explore_adf --epsilon 0.1 --quiet", nullptr, false, nullptr, nullptr);
@@ -96,6 +110,14 @@ BENCHMARK_CAPTURE(benchmark_learn_simple, 8_features,
     "1 zebra|MetricFeatures:3.28 height:1.5 length:2.0 |Says black with white stripes |OtherFeatures NumberOfLegs:4.0 "
     "HasStripes");
 BENCHMARK_CAPTURE(benchmark_learn_simple, 1_feature, "1 | a");
+BENCHMARK_CAPTURE(benchmark_learn_simple, 120_features, "1" + get_x_string_fts_no_label(120));
+BENCHMARK_CAPTURE(
+    benchmark_learn_simple, 120_features_simd_predict, "1" + get_x_string_fts_no_label(120), " --simd_predict");
+
+BENCHMARK_CAPTURE(benchmark_oaa_predict, 120_features, "1" + get_x_string_fts_no_label(120))
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000);
 
 BENCHMARK_CAPTURE(benchmark_ccb_adf_learn, few_features, "a");
 BENCHMARK_CAPTURE(benchmark_ccb_adf_learn, many_features, "a b c d e f g h i j k l m n o p q r s t u v w x y z");
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "array_parameters_dense.h"
+
+// Random strided reads and writes over a dense table of 2^bits weights with stride 4, the access pattern of hashed
+// features with --adaptive --normalized. Run with -b 28 style sizes the table is 4GB and dominated by TLB misses.
+static void bench_dense_random_access(benchmark::State& state, VW::hugepage_mode hugepages, VW::numa_mode numa)
+{
+  const auto bits = static_cast<uint32_t>(state.range(0));
+  VW::weight_allocation allocation;
+  allocation.hugepages = hugepages;
+  allocation.numa = numa;
+  dense_parameters weights(size_t(1) << bits, 2, allocation);
+  // Touch every page once so that first faults are not measured.
+  for (auto w = weights.begin(); w != weights.end(); ++w) { *w = 1.f; }
+
+  const size_t num_accesses = 1 << 20;
+  std::vector<uint64_t> indices(num_accesses);
+  uint64_t state_bits = 0x9E3779B97F4A7C15ULL;
+  for (auto& index : indices)
+  {
+    state_bits ^= state_bits << 13;
+    state_bits ^= state_bits >> 7;
+    state_bits ^= state_bits << 17;
+    index = state_bits << 2;
+  }
+
+  for (auto _ : state)
+  {
+    float sum = 0.f;
+    for (uint64_t index : indices)
+    {
+      weight& w = weights[index];
+      sum += w * (&w)[1];
+      (&w)[2] += 0.5f;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * num_accesses);
+}
+
+BENCHMARK_CAPTURE(bench_dense_random_access, default_pages, VW::hugepage_mode::off, VW::numa_mode::off)
+    ->Arg(18)
+    ->Arg(24)
+    ->Arg(28);
+#if defined(__linux__)
+BENCHMARK_CAPTURE(bench_dense_random_access, transparent_hugepages, VW::hugepage_mode::transparent, VW::numa_mode::off)
+    ->Arg(18)
+    ->Arg(24)
+    ->Arg(28);
+BENCHMARK_CAPTURE(
+    bench_dense_random_access, transparent_hugepages_interleaved, VW::hugepage_mode::transparent, VW::numa_mode::interleave)
+    ->Arg(28);
+#endif
@@ -13,6 +13,7 @@ PREDREF=$NAME.predref
 PREDOUT=$NAME.predict
 NETCAT_STATUS=$NAME.netcat-status
 PORT=54248
+Children="--num_children 1"
 
 while [ $# -gt 0 ]
 do
@@ -27,6 +28,10 @@ do
             PORT="$2"
             shift 
             ;;
+        --threads)
+            Children="--daemon_threads $2"
+            shift
+            ;;
         *)
             echo "$NAME: unknown argument $1"
             exit 1
@@ -67,7 +72,7 @@ else
 fi
 
 # A command (+pattern) that is unlikely to match anything but our own test
-DaemonCmd="$VW -t -i $MODEL --daemon $Foreground --num_children 1 --quiet --port $PORT $JSON"
+DaemonCmd="$VW -t -i $MODEL --daemon $Foreground $Children --quiet --port $PORT $JSON"
 # libtool may wrap vw with '.libs/lt-vw' so we need to be flexible
 # on the exact process pattern we try to kill.
 DaemonPat=`echo $DaemonCmd | sed 's/^[^ ]*vw /.*vw /'`
@@ -15,3 +15,74 @@ BOOST_AUTO_TEST_CASE(cb_explore_adf_should_throw_empty_multi_example) {
   BOOST_REQUIRE_THROW(vw->learn(example_collection), VW::vw_exception);
   VW::finish(*vw);
 }
+
+namespace
+{
+multi_ex parse_multiline(vw& all, const std::vector<std::string>& lines)
+{
+  multi_ex examples;
+  for (const auto& line : lines) { examples.push_back(VW::read_example(all, line)); }
+  return examples;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(cb_adf_factorize_shared_matches_merged_prediction) {
+  const std::string args = "--cb_adf -q UA -q UU -q VA --quiet";
+  auto& merged = *VW::initialize(args, nullptr, false, nullptr, nullptr);
+  auto& factorized = *VW::initialize(args + " --factorize_shared", nullptr, false, nullptr, nullptr);
+
+  const std::vector<std::vector<std::string>> train = {
+      {"shared |U a b:0.5 c |V v1", "0:1.0:0.5 |A x1 x2 |V w1", "|A x3", "|A x1 x4:2"},
+      {"shared |U b c:2 d |V v2", "|A x1 x2 |V w1", "0:0.2:0.5 |A x3", "|A x1 x4:2"},
+      {"shared |U a d |V v1 v2", "|A x1 x2 |V w2", "|A x3", "0:0.7:0.5 |A x1 x4:2"}};
+  for (size_t pass = 0; pass < 4; pass++)
+  {
+    for (const auto& lines : train)
+    {
+      for (auto* all : {&merged, &factorized})
+      {
+        auto examples = parse_multiline(*all, lines);
+        all->learn(examples);
+        all->finish_example(examples);
+      }
+    }
+  }
+
+  // Predicted twice to cover the shared scores of a model left over from the first prediction.
+  const std::vector<std::string> test = {"shared |U a c d:0.3 |V v2", "|A x1 x2 |V w1", "|A x3", "|A x1 x4:2 |V w2"};
+  for (size_t repeat = 0; repeat < 2; repeat++)
+  {
+    auto merged_examples = parse_multiline(merged, test);
+    auto factorized_examples = parse_multiline(factorized, test);
+    merged.predict(merged_examples);
+    factorized.predict(factorized_examples);
+
+    const auto& expected = merged_examples[0]->pred.a_s;
+    const auto& actual = factorized_examples[0]->pred.a_s;
+    BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      BOOST_CHECK_EQUAL(expected[i].action, actual[i].action);
+      BOOST_CHECK_CLOSE(expected[i].score, actual[i].score, 0.001f);
+    }
+    // The actions are left with the features they were read with.
+    for (size_t i = 0; i < test.size(); i++)
+    { BOOST_CHECK_EQUAL(merged_examples[i]->indices.size(), factorized_examples[i]->indices.size()); }
+
+    merged.finish_example(merged_examples);
+    factorized.finish_example(factorized_examples);
+  }
+
+  VW::finish(merged);
+  VW::finish(factorized);
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_factorize_shared_rejects_unsupported_reductions) {
+  BOOST_REQUIRE_THROW(
+      VW::initialize("--cb_explore_adf --squarecb --factorize_shared --quiet", nullptr, false, nullptr, nullptr),
+      VW::vw_exception);
+}
+
+BOOST_AUTO_TEST_CASE(cb_adf_factorize_shared_requires_multiline_reduction) {
+  BOOST_REQUIRE_THROW(VW::initialize("--factorize_shared --quiet", nullptr, false, nullptr, nullptr), VW::vw_exception);
+}
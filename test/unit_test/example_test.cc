@@ -6,6 +6,8 @@
 #include <boost/test/test_tools.hpp>
 
 #include "example.h"
+#include "parser.h"
+#include "vw.h"
 
 BOOST_AUTO_TEST_CASE(example_move_ctor_moves_pred)
 {
@@ -32,3 +34,41 @@ BOOST_AUTO_TEST_CASE(example_move_assign_op_moves_pred)
   BOOST_CHECK_EQUAL(ex.pred.a_s.size(), 0);
   BOOST_CHECK_EQUAL(ex2.pred.a_s.size(), 1);
 }
+
+BOOST_AUTO_TEST_CASE(example_storage_is_kept_between_uses)
+{
+  auto vw = VW::initialize("--quiet");
+  auto* ex = VW::read_example(*vw, "1 |a x y z |b w");
+  features& fs = ex->feature_space['a'];
+  const auto* values = fs.values.data();
+  const size_t capacity = fs.values.capacity();
+
+  VW::empty_example(*vw, *ex);
+  BOOST_CHECK_EQUAL(fs.values.size(), 0);
+  BOOST_CHECK_EQUAL(fs.values.capacity(), capacity);
+  BOOST_CHECK(fs.values.data() == values);
+  BOOST_CHECK(ex->indices.empty());
+
+  // Namespaces a, b and the constant namespace hold 5 features of a float value and a 64 bit index.
+  const auto& stats = vw->example_parser->storage_stats;
+  BOOST_CHECK_EQUAL(stats.max_used, 5 * 12 + 3);
+  BOOST_CHECK_GE(stats.max_retained, stats.max_used);
+  BOOST_CHECK_EQUAL(stats.released, 0);
+
+  VW::finish_example(*vw, *ex);
+  VW::finish(*vw);
+}
+
+BOOST_AUTO_TEST_CASE(example_storage_is_released_above_limit)
+{
+  auto vw = VW::initialize("--quiet");
+  auto* ex = VW::read_example(*vw, "1 |a x");
+  ex->feature_space['a'].values.reserve(2 << 20);
+
+  VW::empty_example(*vw, *ex);
+  BOOST_CHECK_LT(ex->feature_space['a'].values.capacity(), 2 << 20);
+  BOOST_CHECK_EQUAL(vw->example_parser->storage_stats.released, 1);
+
+  VW::finish_example(*vw, *ex);
+  VW::finish(*vw);
+}
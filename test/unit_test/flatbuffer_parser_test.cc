@@ -130,4 +130,46 @@ BOOST_AUTO_TEST_CASE(test_flatbuffer_collection)
 
   VW::finish_example(*all, *examples[0]);
   VW::finish(*all);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(test_flatbuffer_packed_features)
+{
+  auto all = VW::initialize("--no_stdin --quiet --flatbuffer", nullptr, false, nullptr, nullptr);
+
+  flatbuffers::FlatBufferBuilder builder;
+
+  std::vector<flatbuffers::Offset<VW::parsers::flatbuffer::Namespace>> namespaces;
+  std::vector<uint64_t> hashes = {3, 5, 7};
+  std::vector<float> values = {0.5f, 1.5f, 2.5f};
+  namespaces.push_back(
+      VW::parsers::flatbuffer::CreateNamespaceDirect(builder, nullptr, 'a', nullptr, &hashes, &values));
+  std::vector<uint64_t> binary_hashes = {11, 13};
+  namespaces.push_back(
+      VW::parsers::flatbuffer::CreateNamespaceDirect(builder, nullptr, 'b', nullptr, &binary_hashes, nullptr));
+  auto label = get_label(builder, VW::parsers::flatbuffer::Label_SimpleLabel);
+  auto example = VW::parsers::flatbuffer::CreateExampleDirect(
+      builder, &namespaces, VW::parsers::flatbuffer::Label_SimpleLabel, label);
+  builder.FinishSizePrefixed(
+      CreateExampleRoot(builder, VW::parsers::flatbuffer::ExampleType_Example, example.Union()));
+
+  v_array<example*> examples;
+  examples.push_back(&VW::get_unused_example(all));
+  all->flat_converter->parse_examples(all, examples, builder.GetBufferPointer());
+
+  const auto& a = examples[0]->feature_space['a'];
+  BOOST_CHECK_EQUAL(a.size(), 3);
+  for (size_t i = 0; i < hashes.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(a.indicies[i], hashes[i]);
+    BOOST_CHECK_CLOSE(a.values[i], values[i], FLOAT_TOL);
+  }
+  BOOST_CHECK_CLOSE(a.sum_feat_sq, 0.25f + 2.25f + 6.25f, FLOAT_TOL);
+
+  const auto& b = examples[0]->feature_space['b'];
+  BOOST_CHECK_EQUAL(b.size(), 2);
+  BOOST_CHECK_EQUAL(b.indicies[1], 13);
+  BOOST_CHECK_CLOSE(b.values[1], 1.f, FLOAT_TOL);
+
+  VW::finish_example(*all, *examples[0]);
+  VW::finish(*all);
+}
@@ -0,0 +1,189 @@
+#ifndef STATIC_LINK_VW
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "gd.h"
+#include "gd_simd.h"
+#include "vw.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr uint64_t stride = 4;
+constexpr uint64_t num_weights = 1 << 10;
+constexpr uint64_t mask = num_weights * stride - 1;
+
+// Indices are multiples of the stride like the ones the parser produces, with some outside of the weights so the mask
+// is exercised.
+features make_features(size_t count, std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> value(-2.f, 2.f);
+  features fs;
+  for (size_t i = 0; i < count; i++) { fs.push_back(value(rng), (rng() % (4 * num_weights)) * stride); }
+  return fs;
+}
+
+std::vector<float> make_weights(std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> weight(0.5f, 2.f);
+  std::vector<float> weights(num_weights * stride);
+  for (auto& w : weights) { w = weight(rng); }
+  return weights;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(gd_simd_dense_dot_matches_scalar)
+{
+  std::mt19937 rng(7);
+  const auto weights = make_weights(rng);
+  // Counts around the block size exercise the scalar tail.
+  for (size_t count : {0, 1, 7, 8, 9, 16, 17, 100})
+  {
+    const features fs = make_features(count, rng);
+    float expected = 0.f;
+    for (size_t i = 0; i < count; i++) { expected += fs.values[i] * weights[(fs.indicies[i] + 1) & mask]; }
+    BOOST_CHECK_SMALL(GD::simd::dense_dot(weights.data(), mask, fs, 1) - expected, 1e-4f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gd_simd_predictions_match_sparse_weights)
+{
+  // Sparse weights always go through the scalar loop.
+  std::string examples[3];
+  std::mt19937 rng(3);
+  for (auto& e : examples)
+  {
+    e = std::to_string(rng() % 2) + " |a";
+    for (size_t i = 0; i < 40; i++) { e += " f" + std::to_string(rng() % 200) + ":0.5"; }
+    e += " |b x y z";
+  }
+
+  float predictions[2];
+  size_t k = 0;
+  for (const char* args : {"--quiet -q ab", "--quiet -q ab --sparse_weights"})
+  {
+    auto& vw = *VW::initialize(args);
+    for (size_t pass = 0; pass < 3; pass++)
+    {
+      for (const auto& e : examples)
+      {
+        auto& ex = *VW::read_example(vw, e);
+        vw.learn(ex);
+        vw.finish_example(ex);
+      }
+    }
+    auto& ex = *VW::read_example(vw, examples[0]);
+    vw.predict(ex);
+    predictions[k++] = ex.pred.scalar;
+    vw.finish_example(ex);
+    VW::finish(vw);
+  }
+  BOOST_CHECK_CLOSE(predictions[0], predictions[1], 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(gd_simd_predict_is_opt_in)
+{
+  // Dense predictions are rounded exactly like the scalar loop unless --simd_predict is given.
+  std::string examples[3];
+  std::mt19937 rng(9);
+  for (auto& e : examples)
+  {
+    e = std::to_string(rng() % 2) + " |a";
+    for (size_t i = 0; i < 40; i++) { e += " f" + std::to_string(rng() % 200) + ":0." + std::to_string(rng() % 10); }
+    e += " |b x y z";
+  }
+
+  for (const char* args : {"--quiet -q ab", "--quiet -q ab --simd_predict"})
+  {
+    auto& vw = *VW::initialize(args);
+    for (size_t pass = 0; pass < 3; pass++)
+    {
+      for (const auto& e : examples)
+      {
+        auto& ex = *VW::read_example(vw, e);
+        vw.learn(ex);
+        vw.finish_example(ex);
+      }
+    }
+    for (const auto& e : examples)
+    {
+      auto& ex = *VW::read_example(vw, e);
+      vw.predict(ex);
+      const float scalar = GD::inline_predict<dense_parameters>(
+          vw.weights.dense_weights, vw.ignore_some_linear, vw.ignore_linear, *ex.interactions, vw.permutations, ex, 0.f);
+      if (vw.simd_predict) { BOOST_CHECK_CLOSE(GD::inline_predict(vw, ex), scalar, 1e-3); }
+      else
+      {
+        BOOST_CHECK_EQUAL(GD::inline_predict(vw, ex), scalar);
+      }
+      vw.finish_example(ex);
+    }
+    VW::finish(vw);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gd_simd_dense_multi_add_matches_scalar)
+{
+  std::mt19937 rng(11);
+  const auto weights = make_weights(rng);
+  std::uniform_real_distribution<float> value(-2.f, 2.f);
+  // Counts around the block size exercise the scalar tail.
+  for (size_t count : {1, 7, 8, 9, 16, 17, 200})
+  {
+    const uint64_t index = (rng() % (num_weights - count)) * stride;
+    const float x = value(rng);
+    std::vector<float> expected(count);
+    for (auto& e : expected) { e = value(rng); }
+    std::vector<float> actual = expected;
+    for (size_t c = 0; c < count; c++) { expected[c] += x * weights[index + c * stride]; }
+
+    GD::simd::dense_multi_add(weights.data(), index, stride, count, x, actual.data());
+    for (size_t c = 0; c < count; c++) { BOOST_CHECK_EQUAL(actual[c], expected[c]); }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(gd_simd_oaa_scores_match_sparse_weights)
+{
+  // Enough classes for the SIMD multipredict, with the weights of the last classes wrapping past the mask for some
+  // features.
+  std::string examples[3];
+  std::mt19937 rng(5);
+  for (auto& e : examples)
+  {
+    e = std::to_string(rng() % 20 + 1) + " |a";
+    for (size_t i = 0; i < 40; i++) { e += " f" + std::to_string(rng() % 200) + ":0.5"; }
+    e += " |b x y z";
+  }
+
+  std::vector<float> scores[2];
+  size_t k = 0;
+  for (const char* args :
+      {"--quiet --oaa 20 --scores -q ab -b 10", "--quiet --oaa 20 --scores -q ab -b 10 --sparse_weights"})
+  {
+    auto& vw = *VW::initialize(args);
+    for (size_t pass = 0; pass < 3; pass++)
+    {
+      for (const auto& e : examples)
+      {
+        auto& ex = *VW::read_example(vw, e);
+        vw.learn(ex);
+        vw.finish_example(ex);
+      }
+    }
+    auto& ex = *VW::read_example(vw, examples[0]);
+    vw.predict(ex);
+    scores[k++].assign(ex.pred.scalars.begin(), ex.pred.scalars.end());
+    vw.finish_example(ex);
+    VW::finish(vw);
+  }
+  BOOST_REQUIRE_EQUAL(scores[0].size(), 20);
+  BOOST_REQUIRE_EQUAL(scores[1].size(), 20);
+  for (size_t c = 0; c < 20; c++) { BOOST_CHECK_CLOSE(scores[0][c], scores[1][c], 1e-3); }
+}
@@ -0,0 +1,67 @@
+#ifndef STATIC_LINK_VW
+#  define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include <string>
+#include <vector>
+
+#include "hash_cache.h"
+#include "parser.h"
+#include "vw.h"
+
+BOOST_AUTO_TEST_CASE(hash_cache_returns_hasher_result)
+{
+  VW::hash_cache_stats stats;
+  std::vector<std::string> tokens = {"a", "short", "exactly8", "a_somewhat_longer_feature_name",
+      "a_feature_name_that_is_far_too_long_to_be_kept_in_the_cache", "1234567890"};
+  for (hash_func_t hasher : {hashall, hashstring})
+  {
+    VW::hash_cache cache(4, stats);
+    for (int round = 0; round < 3; round++)
+    {
+      for (const auto& token : tokens)
+      {
+        for (uint64_t seed : {0, 12345})
+        {
+          BOOST_CHECK_EQUAL(
+              cache.hash(hasher, VW::string_view(token), seed), hasher(token.data(), token.size(), seed));
+        }
+      }
+    }
+  }
+  // Only the three tokens of cacheable length are looked up, with two seeds in three rounds for each hasher.
+  BOOST_CHECK_EQUAL(stats.lookups, 36);
+  BOOST_CHECK_LE(stats.hits, stats.lookups);
+}
+
+BOOST_AUTO_TEST_CASE(hash_cache_parses_same_features)
+{
+  const char* line = "1 |first_namespace some_feature_name:2 another_feature_name a:b |short x y:first_value_string";
+  auto* plain = VW::initialize("--quiet --no_stdin", nullptr, false, nullptr, nullptr);
+  auto* cached = VW::initialize("--quiet --no_stdin --hash_cache 64", nullptr, false, nullptr, nullptr);
+
+  for (int round = 0; round < 2; round++)
+  {
+    auto* expected = VW::read_example(*plain, line);
+    auto* actual = VW::read_example(*cached, line);
+    BOOST_REQUIRE_EQUAL(expected->indices.size(), actual->indices.size());
+    for (size_t i = 0; i < expected->indices.size(); i++)
+    {
+      const auto& expected_fs = expected->feature_space[expected->indices[i]];
+      const auto& actual_fs = actual->feature_space[actual->indices[i]];
+      BOOST_CHECK_EQUAL(expected->indices[i], actual->indices[i]);
+      BOOST_CHECK_EQUAL_COLLECTIONS(expected_fs.indicies.begin(), expected_fs.indicies.end(),
+          actual_fs.indicies.begin(), actual_fs.indicies.end());
+    }
+    VW::finish_example(*plain, *expected);
+    VW::finish_example(*cached, *actual);
+  }
+  cached->example_parser->hash_cache->flush_stats();
+  BOOST_CHECK_GT(cached->example_parser->hash_cache_stats.hits, 0);
+
+  VW::finish(*plain);
+  VW::finish(*cached);
+}
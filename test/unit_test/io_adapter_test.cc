@@ -7,8 +7,13 @@
 
 #include <memory>
 #include <array>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "io/io_adapter.h"
+#include "io_buf.h"
 
 BOOST_AUTO_TEST_CASE(io_adapter_vector_writer)
 {
@@ -58,3 +63,179 @@ BOOST_AUTO_TEST_CASE(io_adapter_buffer_view)
     BOOST_CHECK_EQUAL(std::strncmp(read_buffer3, "test another", 13), 0);
   }
 }
+
+BOOST_AUTO_TEST_CASE(io_adapter_mapped_file_reader)
+{
+  const std::string file_name = "io_adapter_mapped_file_reader.txt";
+  {
+    auto writer = VW::io::open_file_writer(file_name);
+    BOOST_CHECK_EQUAL(writer->write("test another", 12), 12);
+  }
+
+  {
+    auto mapped_reader = VW::io::open_mapped_file_reader(file_name);
+    char read_buffer[5];
+    BOOST_CHECK_EQUAL(mapped_reader->read(read_buffer, 5), 5);
+    BOOST_CHECK_EQUAL(std::strncmp(read_buffer, "test ", 5), 0);
+
+    char* data;
+    size_t len;
+    if (mapped_reader->read_in_place(data, len))
+    {
+      BOOST_CHECK_EQUAL(len, 7);
+      BOOST_CHECK_EQUAL(std::strncmp(data, "another", 7), 0);
+      BOOST_CHECK_EQUAL(mapped_reader->read(read_buffer, 5), 0);
+    }
+
+    BOOST_CHECK_EQUAL(mapped_reader->is_resettable(), true);
+    mapped_reader->reset();
+    char read_buffer2[20];
+    BOOST_CHECK_EQUAL(mapped_reader->read(read_buffer2, 20), 12);
+    BOOST_CHECK_EQUAL(std::strncmp(read_buffer2, "test another", 12), 0);
+  }
+
+  {
+    // Records straddling the end of one mapped file and the start of the next must come out whole.
+    io_buf buffer;
+    buffer.add_file(VW::io::open_mapped_file_reader(file_name));
+    buffer.add_file(VW::io::open_mapped_file_reader(file_name));
+    char* p;
+    BOOST_CHECK_EQUAL(buffer.buf_read(p, 5), 5);
+    BOOST_CHECK_EQUAL(std::strncmp(p, "test ", 5), 0);
+    BOOST_CHECK_EQUAL(buffer.buf_read(p, 10), 10);
+    BOOST_CHECK_EQUAL(std::strncmp(p, "anothertes", 10), 0);
+    BOOST_CHECK_EQUAL(buffer.readto(p, ' '), 2);
+    BOOST_CHECK_EQUAL(std::strncmp(p, "t ", 2), 0);
+    BOOST_CHECK_EQUAL(buffer.buf_read(p, 10), 7);
+    BOOST_CHECK_EQUAL(std::strncmp(p, "another", 7), 0);
+
+    buffer.current = 0;
+    buffer.reset_file(buffer.get_input_files()[0].get());
+    BOOST_CHECK_EQUAL(buffer.readto(p, ' '), 5);
+    BOOST_CHECK_EQUAL(std::strncmp(p, "test ", 5), 0);
+  }
+
+  std::remove(file_name.c_str());
+}
+
+namespace
+{
+std::string read_all(VW::io::reader& reader, size_t read_size)
+{
+  std::string result;
+  std::vector<char> buffer(read_size);
+  ssize_t num_read;
+  while ((num_read = reader.read(buffer.data(), buffer.size())) > 0) { result.append(buffer.data(), num_read); }
+  return result;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(io_adapter_bgzf_round_trip)
+{
+  const std::string file_name = "io_adapter_bgzf_round_trip.gz";
+  // Large enough for a few bgzf members, and not compressible to nothing.
+  std::string contents;
+  for (int i = 0; i < 50000; i++) { contents += std::to_string(i * 7919 % 100003) + " | a b c\n"; }
+  {
+    auto writer = VW::io::open_compressed_file_writer(file_name);
+    BOOST_CHECK_EQUAL(writer->write(contents.data(), 1000), 1000);
+    BOOST_CHECK_EQUAL(writer->write(contents.data() + 1000, contents.size() - 1000), contents.size() - 1000);
+  }
+
+  for (size_t num_threads : {1, 3})
+  {
+    auto reader = VW::io::create_decompressing_reader(VW::io::open_file_reader(file_name), num_threads);
+    BOOST_CHECK(read_all(*reader, 4096) == contents);
+    BOOST_CHECK_EQUAL(reader->is_resettable(), true);
+    reader->reset();
+    BOOST_CHECK(read_all(*reader, 100000) == contents);
+  }
+
+  // bgzf is still plain gzip to everybody else.
+  auto gzip_reader = VW::io::open_compressed_file_reader(file_name);
+  BOOST_CHECK(read_all(*gzip_reader, 4096) == contents);
+
+  std::remove(file_name.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(io_adapter_decompressing_reader_streams)
+{
+  // Two concatenated gzip members without the bgzf extra field, which have to be inflated in order.
+  const unsigned char gzip_members[] = {0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x33, 0x54, 0xa8,
+      0x51, 0x48, 0xe4, 0x02, 0x00, 0x93, 0xb0, 0xb2, 0x3a, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x02, 0x03, 0xd3, 0x35, 0x54, 0xa8, 0x51, 0x48, 0xe2, 0x02, 0x00, 0xd1, 0xc5, 0x5b, 0x93, 0x07, 0x00,
+      0x00, 0x00};
+  auto gzip_reader = VW::io::create_decompressing_reader(
+      VW::io::create_buffer_view(reinterpret_cast<const char*>(gzip_members), sizeof(gzip_members)), 2);
+  BOOST_CHECK_EQUAL(read_all(*gzip_reader, 3), "1 | a\n-1 | b\n");
+
+  // Input which is not compressed is passed through.
+  const std::string text = "1 | a\n";
+  auto text_reader = VW::io::create_decompressing_reader(VW::io::create_buffer_view(text.data(), text.size()), 2);
+  BOOST_CHECK_EQUAL(read_all(*text_reader, 3), text);
+}
+
+#ifdef BUILD_ZSTD
+BOOST_AUTO_TEST_CASE(io_adapter_decompressing_reader_zstd)
+{
+  // A frame which states its size, decompressed by a worker, followed by one that does not and is streamed.
+  const unsigned char zstd_frames[] = {0x28, 0xb5, 0x2f, 0xfd, 0x24, 0x06, 0x31, 0x00, 0x00, 0x31, 0x20, 0x7c, 0x20,
+      0x61, 0x0a, 0x77, 0x87, 0xcd, 0xfd, 0x28, 0xb5, 0x2f, 0xfd, 0x04, 0x58, 0x39, 0x00, 0x00, 0x2d, 0x31, 0x20, 0x7c,
+      0x20, 0x62, 0x0a, 0xb8, 0xb2, 0xad, 0x58};
+  auto reader = VW::io::create_decompressing_reader(
+      VW::io::create_buffer_view(reinterpret_cast<const char*>(zstd_frames), sizeof(zstd_frames)), 2);
+  BOOST_CHECK_EQUAL(read_all(*reader, 3), "1 | a\n-1 | b\n");
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(io_adapter_read_ahead_reader)
+{
+  std::string contents;
+  for (int i = 0; i < 1000; i++) { contents += std::to_string(i) + " | a b c\n"; }
+
+  // Buffers which do not line up with the reads of the caller.
+  auto reader = VW::io::create_read_ahead_reader(VW::io::create_buffer_view(contents.data(), contents.size()), 100, 3);
+  BOOST_CHECK(reader->is_resettable());
+  BOOST_CHECK(read_all(*reader, 7) == contents);
+  BOOST_CHECK_EQUAL(reader->read(nullptr, 0), 0);
+  reader->reset();
+  BOOST_CHECK(read_all(*reader, 4096) == contents);
+
+  // Reads through io_buf like the parser does.
+  io_buf buf;
+  buf.add_file(VW::io::create_read_ahead_reader(VW::io::create_buffer_view(contents.data(), contents.size()), 64, 2));
+  char* line;
+  size_t num_lines = 0;
+  size_t len;
+  while ((len = buf.readto(line, '\n')) > 0)
+  {
+    BOOST_CHECK_EQUAL(std::string(line, len), std::to_string(num_lines) + " | a b c\n");
+    num_lines++;
+  }
+  BOOST_CHECK_EQUAL(num_lines, 1000);
+}
+
+namespace
+{
+struct failing_reader : public VW::io::reader
+{
+  failing_reader() : reader(false) {}
+  ssize_t read(char* buffer, size_t num_bytes) override
+  {
+    if (_done) { THROW("read failed"); }
+    _done = true;
+    std::memset(buffer, 'x', num_bytes);
+    return static_cast<ssize_t>(num_bytes);
+  }
+  bool _done = false;
+};
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(io_adapter_read_ahead_reader_rethrows)
+{
+  // Data read before the failure is still returned.
+  auto reader = VW::io::create_read_ahead_reader(std::unique_ptr<VW::io::reader>(new failing_reader()), 16, 2);
+  char buffer[16];
+  BOOST_CHECK_EQUAL(reader->read(buffer, sizeof(buffer)), 16);
+  BOOST_CHECK_THROW(reader->read(buffer, sizeof(buffer)), VW::vw_exception);
+}
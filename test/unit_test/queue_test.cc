@@ -0,0 +1,67 @@
+#ifndef STATIC_LINK_VW
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "queue.h"
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(spsc_ptr_queue_fifo_test)
+{
+  VW::spsc_ptr_queue<int> queue{3};
+  std::vector<int> items{1, 2, 3};
+
+  for (auto& item : items) { queue.push(&item); }
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+
+  BOOST_CHECK_EQUAL(queue.pop(), &items[0]);
+  BOOST_CHECK_EQUAL(queue.pop(), &items[1]);
+  BOOST_CHECK_EQUAL(queue.size(), 1);
+
+  queue.push(&items[0]);
+  BOOST_CHECK_EQUAL(queue.pop(), &items[2]);
+  BOOST_CHECK_EQUAL(queue.pop(), &items[0]);
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(spsc_ptr_queue_done_test)
+{
+  VW::spsc_ptr_queue<int> queue{4};
+  int item = 0;
+  queue.push(&item);
+  queue.set_done();
+
+  // Items pushed before set_done are still handed out.
+  BOOST_CHECK_EQUAL(queue.pop(), &item);
+  BOOST_CHECK(queue.pop() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(spsc_ptr_queue_threaded_test)
+{
+  const size_t num_items = 100000;
+  std::vector<size_t> items(num_items);
+  for (size_t i = 0; i < num_items; i++) { items[i] = i; }
+
+  // A small ring forces both sides to block on each other.
+  VW::spsc_ptr_queue<size_t> queue{2};
+  std::thread producer([&] {
+    for (auto& item : items) { queue.push(&item); }
+    queue.set_done();
+  });
+
+  size_t expected = 0;
+  bool in_order = true;
+  while (auto* item = queue.pop())
+  {
+    in_order &= (*item == expected);
+    expected++;
+  }
+  producer.join();
+
+  BOOST_CHECK(in_order);
+  BOOST_CHECK_EQUAL(expected, num_items);
+}
@@ -0,0 +1,82 @@
+#ifndef STATIC_LINK_VW
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "stream_vbyte.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector<uint32_t> make_values(size_t count)
+{
+  // Mix all four encoded lengths.
+  std::mt19937 rng(42);
+  std::vector<uint32_t> values;
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint32_t bits = 8 * (rng() % 4 + 1);
+    values.push_back(bits == 32 ? rng() : rng() & ((1U << bits) - 1));
+  }
+  return values;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(stream_vbyte_encoded_lengths)
+{
+  const std::vector<uint32_t> values{0, 255, 256, 65535, 65536, 16777215, 16777216, UINT32_MAX};
+  std::vector<uint8_t> control(VW::stream_vbyte::control_bytes(values.size()));
+  std::vector<uint8_t> data(VW::stream_vbyte::max_data_bytes(values.size()));
+
+  const size_t data_size = VW::stream_vbyte::encode(values.data(), values.size(), control.data(), data.data());
+  BOOST_CHECK_EQUAL(data_size, 1 + 1 + 2 + 2 + 3 + 3 + 4 + 4);
+  BOOST_CHECK_EQUAL(control[0], 0x50);  // lengths 1, 1, 2, 2
+  BOOST_CHECK_EQUAL(control[1], 0xfa);  // lengths 3, 3, 4, 4
+}
+
+BOOST_AUTO_TEST_CASE(stream_vbyte_round_trip)
+{
+  // Counts which are not a multiple of 4 and short inputs exercise the scalar tail of the SIMD decoder.
+  for (size_t count : {0, 1, 3, 4, 5, 17, 64, 1000})
+  {
+    const auto values = make_values(count);
+    std::vector<uint8_t> control(VW::stream_vbyte::control_bytes(count));
+    std::vector<uint8_t> data(VW::stream_vbyte::max_data_bytes(count));
+    const size_t data_size = VW::stream_vbyte::encode(values.data(), count, control.data(), data.data());
+
+    std::vector<uint32_t> decoded(count);
+    BOOST_CHECK_EQUAL(VW::stream_vbyte::decode(control.data(), data.data(), data_size, count, decoded.data()), data_size);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(), values.begin(), values.end());
+
+    std::vector<uint32_t> scalar_decoded(count);
+    BOOST_CHECK_EQUAL(
+        VW::stream_vbyte::decode_scalar(control.data(), data.data(), count, scalar_decoded.data()), data_size);
+    BOOST_CHECK_EQUAL_COLLECTIONS(scalar_decoded.begin(), scalar_decoded.end(), values.begin(), values.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stream_vbyte_decode_in_batches)
+{
+  // The cache decodes long namespaces in batches which are a multiple of 4 values.
+  const auto values = make_values(103);
+  std::vector<uint8_t> control(VW::stream_vbyte::control_bytes(values.size()));
+  std::vector<uint8_t> data(VW::stream_vbyte::max_data_bytes(values.size()));
+  const size_t data_size = VW::stream_vbyte::encode(values.data(), values.size(), control.data(), data.data());
+
+  std::vector<uint32_t> decoded(values.size());
+  size_t offset = 0;
+  for (size_t done = 0; done < values.size(); done += 8)
+  {
+    const size_t n = std::min<size_t>(8, values.size() - done);
+    offset += VW::stream_vbyte::decode(
+        control.data() + done / 4, data.data() + offset, data_size - offset, n, decoded.data() + done);
+  }
+  BOOST_CHECK_EQUAL(offset, data_size);
+  BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(), values.begin(), values.end());
+}
@@ -143,3 +143,38 @@ BOOST_AUTO_TEST_CASE(basic_tokenize_to_argv) {
   for (int i = 0; i < argc; i++) free(argv[i]);
   free(argv);
 }
+
+BOOST_AUTO_TEST_CASE(find_first_of_delimiters) {
+  // Long enough that the delimiters are found both in full 16 character blocks and in the tail.
+  std::string str = "a_rather_long_feature_name:0.5 another_long_feature_name|ns x\ty\r";
+  VW::string_view sv(str);
+
+  BOOST_CHECK_EQUAL((VW::find_first_of<' ', ':', '\t', '|', '\r'>(sv, 0)), str.find(':'));
+  BOOST_CHECK_EQUAL((VW::find_first_of<' ', ':', '\t', '|', '\r'>(sv, str.find(':') + 1)), str.find(' '));
+  BOOST_CHECK_EQUAL((VW::find_first_of<'|'>(sv, 0)), str.find('|'));
+  BOOST_CHECK_EQUAL((VW::find_first_of<'\t'>(sv, 0)), str.find('\t'));
+  BOOST_CHECK_EQUAL((VW::find_first_of<'\r'>(sv, 0)), str.size() - 1);
+  BOOST_CHECK_EQUAL((VW::find_first_of<'\n'>(sv, 0)), str.size());
+  BOOST_CHECK_EQUAL((VW::find_first_of<'\n'>(sv, str.size())), str.size());
+}
+
+BOOST_AUTO_TEST_CASE(find_first_of_matches_scalar_scan) {
+  // Delimiters are sparse and spread irregularly so that some blocks have none, some one and some several.
+  const char delimiters[] = ": |\t\r\n";
+  for (size_t length = 0; length < 70; length++)
+  {
+    std::string str;
+    for (size_t i = 0; i < length; i++)
+    {
+      size_t r = (i * i * 7 + length) % 29;
+      str += r < sizeof(delimiters) - 1 ? delimiters[r] : static_cast<char>('a' + r);
+    }
+    VW::string_view sv(str);
+    for (size_t pos = 0; pos <= length; pos++)
+    {
+      size_t expected = str.find_first_of(" :\t|\r", pos);
+      if (expected == std::string::npos) { expected = length; }
+      BOOST_CHECK_EQUAL((VW::find_first_of<' ', ':', '\t', '|', '\r'>(sv, pos)), expected);
+    }
+  }
+}
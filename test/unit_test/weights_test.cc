@@ -26,3 +26,29 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_default_function_weight_initialization_stride
   }
 }
 
+#if defined(__linux__)
+BOOST_AUTO_TEST_CASE(test_dense_weights_on_transparent_hugepages)
+{
+  VW::weight_allocation allocation;
+  VW::parse_hugepage_mode("transparent", allocation);
+  dense_parameters w(LENGTH, STRIDE_SHIFT, allocation);
+  BOOST_REQUIRE(w.not_null());
+  for (size_t i = 0; i < LENGTH; i++) { BOOST_CHECK_EQUAL(w.strided_index(i), 0.f); }
+  w.strided_index(LENGTH - 1) = 2.f;
+  BOOST_CHECK_EQUAL(w[(LENGTH - 1) << STRIDE_SHIFT], 2.f);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(test_weight_allocation_arguments)
+{
+  VW::weight_allocation allocation;
+  VW::parse_numa_mode("interleave", allocation);
+  BOOST_CHECK(allocation.numa == VW::numa_mode::interleave);
+  VW::parse_numa_mode("1", allocation);
+  BOOST_CHECK(allocation.numa == VW::numa_mode::bind);
+  BOOST_CHECK_EQUAL(allocation.numa_node, 1);
+  VW::parse_hugepage_mode("explicit", allocation);
+  BOOST_CHECK(allocation.hugepages == VW::hugepage_mode::explicit_pages);
+  BOOST_CHECK_THROW(VW::parse_numa_mode("node1", allocation), VW::vw_exception);
+  BOOST_CHECK_THROW(VW::parse_hugepage_mode("always", allocation), VW::vw_exception);
+}
@@ -0,0 +1,119 @@
+#ifndef STATIC_LINK_VW
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_tools.hpp>
+
+#include "worker_pool.h"
+#include "vw.h"
+#include "vw_exception.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(worker_pool_runs_every_iteration_once)
+{
+  VW::worker_pool pool(4);
+  BOOST_CHECK_EQUAL(pool.num_threads(), 4);
+
+  for (size_t count : {0, 1, 3, 1000})
+  {
+    std::vector<std::atomic<int>> runs(count);
+    for (auto& r : runs) { r = 0; }
+    std::vector<std::atomic<int>> threads_used(pool.num_threads());
+    for (auto& t : threads_used) { t = 0; }
+
+    pool.for_each(count, [&runs, &threads_used](size_t i, size_t thread) {
+      runs[i]++;
+      threads_used[thread]++;
+    });
+
+    for (const auto& r : runs) { BOOST_CHECK_EQUAL(r.load(), 1); }
+    int total = 0;
+    for (const auto& t : threads_used) { total += t.load(); }
+    BOOST_CHECK_EQUAL(total, count);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(worker_pool_of_one_runs_on_caller)
+{
+  VW::worker_pool pool(1);
+  const auto caller = std::this_thread::get_id();
+  size_t runs = 0;
+  pool.for_each(10, [&runs, caller](size_t, size_t thread) {
+    BOOST_CHECK(std::this_thread::get_id() == caller);
+    BOOST_CHECK_EQUAL(thread, 0);
+    runs++;
+  });
+  BOOST_CHECK_EQUAL(runs, 10);
+}
+
+BOOST_AUTO_TEST_CASE(worker_pool_rethrows_and_stays_usable)
+{
+  VW::worker_pool pool(3);
+  BOOST_REQUIRE_THROW(pool.for_each(100,
+                          [](size_t i, size_t) {
+                            if (i == 17) { throw std::runtime_error("failed"); }
+                          }),
+      std::runtime_error);
+
+  std::atomic<size_t> runs{0};
+  pool.for_each(100, [&runs](size_t, size_t) { runs++; });
+  BOOST_CHECK_EQUAL(runs.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(csoaa_ldf_predict_threads_matches_single_thread)
+{
+  const std::string args = "--csoaa_ldf multiline --csoaa_rank -q ab --quiet";
+  auto& single = *VW::initialize(args, nullptr, false, nullptr, nullptr);
+  auto& threaded = *VW::initialize(args + " --ldf_predict_threads 3", nullptr, false, nullptr, nullptr);
+
+  auto make_examples = [](vw& all, size_t num_actions, size_t label) {
+    multi_ex examples;
+    for (size_t i = 0; i < num_actions; i++)
+    {
+      const std::string cost = i == label ? ":0" : ":1";
+      examples.push_back(VW::read_example(all, std::to_string(i + 1) + cost + " |a u1 u2:0.5 |b f" +
+              std::to_string(i % 7) + " g" + std::to_string(i % 5) + ":0.3"));
+    }
+    return examples;
+  };
+
+  for (size_t label = 0; label < 20; label++)
+  {
+    for (auto* all : {&single, &threaded})
+    {
+      auto examples = make_examples(*all, 40, label % 9);
+      all->learn(examples);
+      all->finish_example(examples);
+    }
+  }
+
+  auto single_examples = make_examples(single, 40, 0);
+  auto threaded_examples = make_examples(threaded, 40, 0);
+  single.predict(single_examples);
+  threaded.predict(threaded_examples);
+  const auto& expected = single_examples[0]->pred.a_s;
+  const auto& actual = threaded_examples[0]->pred.a_s;
+  BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(expected[i].action, actual[i].action);
+    BOOST_CHECK_EQUAL(expected[i].score, actual[i].score);
+  }
+  single.finish_example(single_examples);
+  threaded.finish_example(threaded_examples);
+
+  VW::finish(single);
+  VW::finish(threaded);
+}
+
+BOOST_AUTO_TEST_CASE(csoaa_ldf_predict_threads_rejects_sparse_weights)
+{
+  BOOST_REQUIRE_THROW(VW::initialize("--csoaa_ldf multiline --ldf_predict_threads 2 --sparse_weights --quiet", nullptr,
+                          false, nullptr, nullptr),
+      VW::vw_exception);
+}
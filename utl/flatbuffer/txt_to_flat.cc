@@ -70,6 +70,7 @@ int main(int argc, char* argv[])
   to_flat converter;
   driver_config.add(make_option("fb_out", converter.output_flatbuffer_name));
   driver_config.add(make_option("collection_size", converter.collection_size));
+  driver_config.add(make_option("packed_features", converter.packed_features));
 
   std::vector<vw*> alls;
 
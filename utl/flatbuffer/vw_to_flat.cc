@@ -3,6 +3,7 @@
 // license as described in the file LICENSE.
 
 #include <sys/timeb.h>
+#include <algorithm>
 #include <fstream>
 #include <vector>
 
@@ -385,6 +386,16 @@ void to_flat::convert_txt_to_flat(vw& all)
           }
           namespace_offset = VW::parsers::flatbuffer::CreateNamespaceDirect(_builder, ns_name.c_str(), ns, &fts);
         }
+        else if (packed_features)
+        {
+          auto& ns_fts = ae->feature_space[ns];
+          std::vector<uint64_t> hashes(ns_fts.indicies.begin(), ns_fts.indicies.end());
+          std::vector<float> values(ns_fts.values.begin(), ns_fts.values.end());
+          // Values are left out when all of them are 1.
+          const bool all_ones = std::all_of(values.begin(), values.end(), [](float v) { return v == 1.f; });
+          namespace_offset = VW::parsers::flatbuffer::CreateNamespaceDirect(
+              _builder, nullptr, ns, nullptr, &hashes, all_ones ? nullptr : &values);
+        }
         else
         {
           for (features::iterator& f : ae->feature_space[ns])
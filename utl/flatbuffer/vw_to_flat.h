@@ -59,6 +59,8 @@ public:
   std::string output_flatbuffer_name;
   size_t collection_size = 0;
   bool collection = false;
+  // Write features as hash and value vectors instead of one table each, unless audit needs their names.
+  bool packed_features = false;
   void convert_txt_to_flat(vw& all);
 
 private:
@@ -7,9 +7,14 @@ This implements the allreduce function of MPI.  Code primarily by
 Alekh Agarwal and John Langford, with help Olivier Chapelle.
 */
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
 #include "global_data.h"
 #include "vw_allreduce.h"
 
@@ -19,28 +24,354 @@ namespace logger = VW::io::logger;
 
 void add_float(float& c1, const float& c2) { c1 += c2; }
 
-void accumulate(vw& all, parameters& weights, size_t offset)
+namespace
 {
-  uint64_t length = UINT64_ONE << all.num_bits;  // This is size of gradient
-  float* local_grad = new float[length];
+void add_byte(uint8_t& c1, const uint8_t& c2) { c1 += c2; }
+void add_uint64(uint64_t& c1, const uint64_t& c2) { c1 += c2; }
 
-  if (weights.sparse)
-    for (uint64_t i = 0; i < length; i++)
-      local_grad[i] = (&(weights.sparse_weights[i << weights.sparse_weights.stride_shift()]))[offset];
+// IEEE half precision with round to nearest even, done in software so that no F16C support is needed.
+uint16_t float_to_half(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t sign = (bits >> 16) & 0x8000;
+  const uint32_t abs = bits & 0x7fffffff;
+
+  if (abs >= 0x7f800000) { return static_cast<uint16_t>(sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0)); }
+  // 65520 and above would round to infinity, they are clamped to the largest half instead.
+  if (abs >= 0x477ff000) { return static_cast<uint16_t>(sign | 0x7bff); }
+  if (abs < 0x38800000)
+  {
+    // Below the smallest normal half, in units of 2^-24.
+    const uint32_t shift = 126 - (abs >> 23);
+    if (shift > 24) { return static_cast<uint16_t>(sign); }
+    const uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+    uint32_t result = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (result & 1))) { result++; }
+    return static_cast<uint16_t>(sign | result);
+  }
+
+  uint32_t result = (abs - 0x38000000) >> 13;
+  const uint32_t remainder = abs & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) { result++; }
+  return static_cast<uint16_t>(sign | result);
+}
+
+float half_to_float(uint16_t value)
+{
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  const uint32_t exponent = (value >> 10) & 0x1f;
+  const uint32_t mantissa = value & 0x3ff;
+  if (exponent == 0)
+  {
+    const float subnormal = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign != 0 ? -subnormal : subnormal;
+  }
+
+  uint32_t bits = sign | (mantissa << 13);
+  bits |= exponent == 0x1f ? 0x7f800000 : (exponent + 112) << 23;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+uint16_t float_to_bfloat16(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if ((bits & 0x7fffffff) > 0x7f800000) { return static_cast<uint16_t>((bits >> 16) | 0x40); }
+  if ((bits & 0x7fffffff) == 0x7f800000) { return static_cast<uint16_t>(bits >> 16); }
+  bits += 0x7fff + ((bits >> 16) & 1);
+  // The largest floats would round to infinity, they are clamped to the largest bfloat16 instead.
+  if ((bits & 0x7f800000) == 0x7f800000) { return static_cast<uint16_t>(((bits >> 16) & 0x8000) | 0x7f7f); }
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float bfloat16_to_float(uint16_t value)
+{
+  const uint32_t bits = static_cast<uint32_t>(value) << 16;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+template <uint16_t (*encode)(float), float (*decode)(uint16_t)>
+void add_encoded(uint16_t& c1, const uint16_t& c2)
+{
+  c1 = encode(decode(c1) + decode(c2));
+}
+
+// Sums values over the nodes at 16 bits. What a node loses rounding its values is kept in residuals, which line up
+// with values, and added to what it sends the next time. Values out of range are clamped, with a warning the first
+// time, and the rest goes to the residual like any rounding error. Sums out of range are clamped as well.
+template <uint16_t (*encode)(float), float (*decode)(uint16_t)>
+void all_reduce_encoded(vw& all, float* values, float* residuals, size_t n)
+{
+  static std::atomic<bool> warned(false);
+  const float largest = decode(encode(std::numeric_limits<float>::max()));
+  size_t clamped = 0;
+  std::vector<uint16_t> encoded(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    const float value = values[i] + residuals[i];
+    encoded[i] = encode(value);
+    residuals[i] = value - decode(encoded[i]);
+    if (std::abs(value) > largest) { clamped++; }
+  }
+  if (clamped > 0 && !all.logger.quiet && !warned.exchange(true))
+  {
+    logger::errlog_warn(
+        "warning: {} weights larger than {} were clamped by --all_reduce_float, the rest is sent with the next syncs",
+        clamped, largest);
+  }
+
+  all_reduce<uint16_t, add_encoded<encode, decode>>(all, encoded.data(), n);
+
+  for (size_t i = 0; i < n; i++) { values[i] = decode(encoded[i]); }
+}
+
+void all_reduce_values(vw& all, float* values, float* residuals, size_t n)
+{
+  switch (all.all_reduce_precision)
+  {
+    case AllReducePrecision::Float16:
+      all_reduce_encoded<float_to_half, half_to_float>(all, values, residuals, n);
+      break;
+    case AllReducePrecision::BFloat16:
+      all_reduce_encoded<float_to_bfloat16, bfloat16_to_float>(all, values, residuals, n);
+      break;
+    default:
+      all_reduce<float, add_float>(all, values, n);
+      break;
+  }
+}
+
+// Every node learns the sorted union of the rows touched on any node. Each node delta encodes its rows as varints and
+// the encodings are gathered with an all_reduce in which every node fills only its own range. Returns false when the
+// encodings would cost more than half of sending every row, all nodes then agree to send them all.
+template <class Touched>
+bool all_reduce_touched_rows(vw& all, uint64_t length, size_t row_bytes, Touched touched, std::vector<uint64_t>& rows)
+{
+  std::vector<uint8_t> encoded;
+  uint64_t previous = 0;
+  for (uint64_t row = 0; row < length; row++)
+  {
+    if (!touched(row)) { continue; }
+    uint64_t delta = row - previous;
+    for (; delta >= 0x80; delta >>= 7) { encoded.push_back(static_cast<uint8_t>((delta & 0x7f) | 0x80)); }
+    encoded.push_back(static_cast<uint8_t>(delta));
+    previous = row;
+  }
+
+  const size_t total = all.all_reduce->total;
+  const size_t node = all.all_reduce->node;
+  std::vector<uint64_t> sizes(total, 0);
+  sizes[node] = encoded.size();
+  all_reduce<uint64_t, add_uint64>(all, sizes.data(), total);
+
+  uint64_t total_bytes = 0;
+  uint64_t own_begin = 0;
+  for (size_t i = 0; i < total; i++)
+  {
+    if (i == node) { own_begin = total_bytes; }
+    total_bytes += sizes[i];
+  }
+  if (total_bytes >= length * row_bytes / 2) { return false; }
+
+  std::vector<uint8_t> gathered(total_bytes, 0);
+  std::copy(encoded.begin(), encoded.end(), gathered.begin() + own_begin);
+  if (total_bytes > 0) { all_reduce<uint8_t, add_byte>(all, gathered.data(), total_bytes); }
+
+  rows.clear();
+  size_t position = 0;
+  for (size_t i = 0; i < total; i++)
+  {
+    const size_t end = position + sizes[i];
+    uint64_t row = 0;
+    while (position < end)
+    {
+      uint64_t delta = 0;
+      for (int shift = 0; position < end; shift += 7)
+      {
+        const uint8_t byte = gathered[position++];
+        delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) { break; }
+      }
+      row += delta;
+      rows.push_back(row);
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  return true;
+}
+
+// Callers of all_reduce_rows, which keep their rounding errors apart per slot.
+enum class residual_owner : size_t
+{
+  sum,
+  average,
+  weighted_avg_adaptive,
+  weighted_avg
+};
+
+// Lines the kept rounding errors up with count rows, row(i) giving the sorted rows, which must include every kept row.
+template <class Row>
+std::vector<float> load_residuals(const all_reduce_residual_rows& kept, size_t width, size_t count, Row row)
+{
+  std::vector<float> residuals(count * width, 0.f);
+  size_t next = 0;
+  for (size_t i = 0; i < count && next < kept.rows.size(); i++)
+  {
+    if (row(i) != kept.rows[next]) { continue; }
+    std::copy(kept.values.begin() + next * width, kept.values.begin() + (next + 1) * width,
+        residuals.begin() + i * width);
+    next++;
+  }
+  return residuals;
+}
+
+// Keeps the rounding errors of the rows that have any.
+template <class Row>
+void keep_residuals(all_reduce_residual_rows& kept, const std::vector<float>& residuals, size_t width, Row row)
+{
+  kept.rows.clear();
+  kept.values.clear();
+  for (size_t i = 0; i < residuals.size() / width; i++)
+  {
+    const auto begin = residuals.begin() + i * width;
+    if (std::any_of(begin, begin + width, [](float residual) { return residual != 0.f; }))
+    {
+      kept.rows.push_back(row(i));
+      kept.values.insert(kept.values.end(), begin, begin + width);
+    }
+  }
+}
+
+// Sums width values of every weight row over the nodes, value(row, j) giving those of this node, and passes the sums
+// to store(row, sums). With --all_reduce_sparse only the rows touched on some node are sent and stored, so rows that
+// are not touched anywhere must already hold their result. The rounding errors at lower precision are kept per
+// caller and slot, only for the rows that have any.
+template <class Touched, class Value, class Store>
+void all_reduce_rows(
+    vw& all, residual_owner owner, size_t slot, size_t width, Touched touched, Value value, Store store)
+{
+  const uint64_t length = UINT64_ONE << all.num_bits;
+  const size_t value_bytes = all.all_reduce_precision == AllReducePrecision::Float32 ? sizeof(float) : sizeof(uint16_t);
+  const bool rounded = all.all_reduce_precision != AllReducePrecision::Float32;
+  all_reduce_residual_rows* kept =
+      rounded ? &all.all_reduce_residuals[std::make_pair(static_cast<size_t>(owner), slot)] : nullptr;
+
+  std::vector<uint64_t> rows;
+  size_t next_kept = 0;
+  const bool sparse = all.all_reduce_sparse &&
+      all_reduce_touched_rows(all, length, width * value_bytes,
+          [&](uint64_t row) {
+            // Rows are asked in increasing order.
+            if (kept != nullptr)
+            {
+              while (next_kept < kept->rows.size() && kept->rows[next_kept] < row) { next_kept++; }
+              if (next_kept < kept->rows.size() && kept->rows[next_kept] == row) { return true; }
+            }
+            return touched(row);
+          },
+          rows);
+
+  if (!sparse)
+  {
+    auto all_rows = [](size_t i) { return static_cast<uint64_t>(i); };
+    std::vector<float> values(length * width);
+    for (uint64_t row = 0; row < length; row++)
+    {
+      for (size_t j = 0; j < width; j++) { values[row * width + j] = value(row, j); }
+    }
+    std::vector<float> residuals;
+    if (kept != nullptr) { residuals = load_residuals(*kept, width, length, all_rows); }
+    all_reduce_values(all, values.data(), residuals.data(), values.size());
+    if (kept != nullptr) { keep_residuals(*kept, residuals, width, all_rows); }
+    for (uint64_t row = 0; row < length; row++) { store(row, values.data() + row * width); }
+    return;
+  }
+
+  if (rows.empty()) { return; }
+  auto touched_rows = [&rows](size_t i) { return rows[i]; };
+  std::vector<float> values(rows.size() * width);
+  for (size_t i = 0; i < rows.size(); i++)
+  {
+    for (size_t j = 0; j < width; j++) { values[i * width + j] = value(rows[i], j); }
+  }
+  std::vector<float> residuals;
+  if (kept != nullptr) { residuals = load_residuals(*kept, width, rows.size(), touched_rows); }
+  all_reduce_values(all, values.data(), residuals.data(), values.size());
+  if (kept != nullptr) { keep_residuals(*kept, residuals, width, touched_rows); }
+  for (size_t i = 0; i < rows.size(); i++) { store(rows[i], values.data() + i * width); }
+}
+
+// Sums the slot at offset of every weight over the nodes and stores the sum divided by divisor.
+template <class T>
+void accumulate_weights(vw& all, T& weights, residual_owner owner, size_t offset, float divisor)
+{
+  auto slot = [&weights, offset](uint64_t row) -> float& {
+    return (&(weights[row << weights.stride_shift()]))[offset];
+  };
+  all_reduce_rows(
+      all, owner, offset, 1, [&](uint64_t row) { return slot(row) != 0.f; },
+      [&](uint64_t row, size_t) { return slot(row); },
+      [&](uint64_t row, const float* sum) { slot(row) = *sum / divisor; });
+}
+
+// Scales a weight by the share of this node in the summed adaptive slot.
+void weight_row(vw& all, float* weight, float summed)
+{
+  if (summed > 0)
+  {
+    float ratio = weight[1] / summed;
+    weight[0] *= ratio;
+    weight[1] *= ratio;                                               // A crude max
+    if (all.normalized_idx > 0) weight[all.normalized_idx] *= ratio;  // A crude max
+  }
   else
-    for (uint64_t i = 0; i < length; i++)
-      local_grad[i] = (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset];
+  {
+    *weight = 0;
+  }
+}
+
+// accumulate_weighted_avg for --all_reduce_sparse and --all_reduce_float.
+void accumulate_weighted_avg_rows(vw& all, dense_parameters& weights)
+{
+  const size_t stride = size_t(1) << weights.stride_shift();
+  auto row_weights = [&weights](uint64_t row) { return &(weights[row << weights.stride_shift()]); };
+
+  // Weights zero on every node keep a zero adaptive sum and are zeroed by weight_row, so they need not be sent.
+  all_reduce_rows(
+      all, residual_owner::weighted_avg_adaptive, 1, 1,
+      [&](uint64_t row) { return row_weights(row)[0] != 0.f || row_weights(row)[1] != 0.f; },
+      [&](uint64_t row, size_t) { return row_weights(row)[1]; },
+      [&](uint64_t row, const float* sum) { weight_row(all, row_weights(row), *sum); });
 
-  all_reduce<float, add_float>(all, local_grad, length);  // TODO: modify to not use first()
+  all_reduce_rows(
+      all, residual_owner::weighted_avg, 0, stride,
+      [&](uint64_t row) {
+        const float* weight = row_weights(row);
+        for (size_t j = 0; j < stride; j++)
+        {
+          if (weight[j] != 0.f) { return true; }
+        }
+        return false;
+      },
+      [&](uint64_t row, size_t j) { return row_weights(row)[j]; },
+      [&](uint64_t row, const float* sums) { std::copy(sums, sums + stride, row_weights(row)); });
+}
+}  // namespace
 
+void accumulate(vw& all, parameters& weights, size_t offset)
+{
   if (weights.sparse)
-    for (uint64_t i = 0; i < length; i++)
-      (&(weights.sparse_weights[i << weights.sparse_weights.stride_shift()]))[offset] = local_grad[i];
+    accumulate_weights(all, weights.sparse_weights, residual_owner::sum, offset, 1.f);
   else
-    for (uint64_t i = 0; i < length; i++)
-      (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset] = local_grad[i];
-
-  delete[] local_grad;
+    accumulate_weights(all, weights.dense_weights, residual_owner::sum, offset, 1.f);
 }
 
 float accumulate_scalar(vw& all, float local_sum)
@@ -52,27 +383,11 @@ float accumulate_scalar(vw& all, float local_sum)
 
 void accumulate_avg(vw& all, parameters& weights, size_t offset)
 {
-  uint32_t length = 1 << all.num_bits;  // This is size of gradient
   float numnodes = (float)all.all_reduce->total;
-  float* local_grad = new float[length];
-
-  if (weights.sparse)
-    for (uint64_t i = 0; i < length; i++)
-      local_grad[i] = (&(weights.sparse_weights[i << weights.sparse_weights.stride_shift()]))[offset];
-  else
-    for (uint64_t i = 0; i < length; i++)
-      local_grad[i] = (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset];
-
-  all_reduce<float, add_float>(all, local_grad, length);  // TODO: modify to not use first()
-
   if (weights.sparse)
-    for (uint64_t i = 0; i < length; i++)
-      (&(weights.sparse_weights[i << weights.sparse_weights.stride_shift()]))[offset] = local_grad[i] / numnodes;
+    accumulate_weights(all, weights.sparse_weights, residual_owner::average, offset, numnodes);
   else
-    for (uint64_t i = 0; i < length; i++)
-      (&(weights.dense_weights[i << weights.dense_weights.stride_shift()]))[offset] = local_grad[i] / numnodes;
-
-  delete[] local_grad;
+    accumulate_weights(all, weights.dense_weights, residual_owner::average, offset, numnodes);
 }
 
 float max_elem(float* arr, int length)
@@ -94,23 +409,7 @@ float min_elem(float* arr, int length)
 template <class T>
 void do_weighting(vw& all, uint64_t length, float* local_weights, T& weights)
 {
-  for (uint64_t i = 0; i < length; i++)
-  {
-    float* weight = &weights[i << weights.stride_shift()];
-    if (local_weights[i] > 0)
-    {
-      float ratio = weight[1] / local_weights[i];
-      local_weights[i] = weight[0] * ratio;
-      weight[0] *= ratio;
-      weight[1] *= ratio;                                               // A crude max
-      if (all.normalized_idx > 0) weight[all.normalized_idx] *= ratio;  // A crude max
-    }
-    else
-    {
-      local_weights[i] = 0;
-      *weight = 0;
-    }
-  }
+  for (uint64_t i = 0; i < length; i++) { weight_row(all, &weights[i << weights.stride_shift()], local_weights[i]); }
 }
 
 void accumulate_weighted_avg(vw& all, parameters& weights)
@@ -122,6 +421,12 @@ void accumulate_weighted_avg(vw& all, parameters& weights)
     return;
   }
 
+  if (!weights.sparse && (all.all_reduce_sparse || all.all_reduce_precision != AllReducePrecision::Float32))
+  {
+    accumulate_weighted_avg_rows(all, weights.dense_weights);
+    return;
+  }
+
   uint32_t length = 1 << all.num_bits;  // This is the number of parameters
   float* local_weights = new float[length];
 
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <algorithm>
+#include <cstring>
 
 #ifdef _WIN32
 #  define NOMINMAX
@@ -47,22 +48,39 @@ typedef int socket_t;
 #ifdef _M_CEE
 #  pragma managed(push, off)
 #  undef _M_CEE
+#  include <atomic>
 #  include <condition_variable>
 #  include <mutex>
 #  define _M_CEE 001
 #  pragma managed(pop)
 #else
+#  include <atomic>
 #  include <condition_variable>
 #  include <mutex>
 #endif
 
 constexpr size_t ar_buf_size = 1 << 16;
+// AllReduceThreads splits the buffers in multiples of a cache line and reduces them a tile at a time.
+constexpr size_t ar_cache_line_size = 64;
+constexpr size_t ar_tile_size = 1 << 12;
+// Times a thread checks the barrier before it sleeps.
+constexpr size_t ar_spin_count = 1 << 10;
+
+// How AllReduceSockets combines the buffers of the nodes. Every node of a job must use the same algorithm.
+enum class AllReduceAlgorithm
+{
+  Tree,  // reduce up the spanning tree, then broadcast back down
+  Ring   // reduce-scatter and allgather around a ring of all nodes
+};
 
 struct node_socks
 {
   std::string current_master;
   socket_t parent;
   socket_t children[2];
+  // Neighbours in the ring, connected on the first ring all_reduce.
+  socket_t ring_next;
+  socket_t ring_prev;
   ~node_socks()
   {
     if (current_master != "")
@@ -71,8 +89,10 @@ struct node_socks
       if (children[0] != -1) CLOSESOCK(this->children[0]);
       if (children[1] != -1) CLOSESOCK(this->children[1]);
     }
+    if (ring_next != -1) CLOSESOCK(this->ring_next);
+    if (ring_prev != -1) CLOSESOCK(this->ring_prev);
   }
-  node_socks() { current_master = ""; }
+  node_socks() : ring_next(static_cast<socket_t>(-1)), ring_prev(static_cast<socket_t>(-1)) { current_master = ""; }
 };
 
 template <class T, void (*f)(T&, const T&)>
@@ -112,10 +132,10 @@ private:
   size_t m_total;
 
   // number of threads reached the barrier
-  uint32_t m_count;
+  std::atomic<size_t> m_count;
 
-  // current wait-barrier-run required to protect against spurious wakeups of m_cv->wait(...)
-  bool m_run;
+  // current wait-barrier-run, flipped by the last thread to arrive
+  std::atomic<bool> m_run;
 
 public:
   AllReduceSync(const size_t total);
@@ -147,36 +167,25 @@ public:
     buffers[node] = buffer;
     m_sync->waitForSynchronization();
 
-    size_t blockSize = n / total;
-    size_t index;
-    size_t end;
-
-    if (blockSize == 0)
+    // Each thread reduces its own contiguous range, and a tile at a time so the sum is still cached when it is
+    // broadcast. The ranges are sized in whole cache lines, so threads only write the same line at the boundaries of
+    // their ranges, and not at all when the buffers are aligned to a cache line. The buffers belong to the callers, so
+    // that alignment is not enforced here.
+    const size_t line = std::max<size_t>(1, ar_cache_line_size / sizeof(T));
+    const size_t lines = (n + line - 1) / line;
+    const size_t index = std::min(n, lines * node / total * line);
+    const size_t end = std::min(n, lines * (node + 1) / total * line);
+    const size_t tile = std::max<size_t>(line, ar_tile_size / sizeof(T));
+
+    for (size_t begin = index; begin < end; begin += tile)
     {
-      if (node < n)
-      {
-        index = node;
-        end = node + 1;
-      }
-      else
-      {  // more threads than bytes --> don't do any work
-        index = end = 0;
-      }
-    }
-    else
-    {
-      index = node * blockSize;
-      end = node == total - 1 ? n : (node + 1) * blockSize;
-    }
+      const size_t length = std::min(tile, end - begin);
+      T* first = buffers[0] + begin;
 
-    for (; index < end; index++)
-    {  // Perform transposed AllReduce to help data locallity
-      T& first = buffers[0][index];
-
-      for (size_t i = 1; i < total; i++) f(first, buffers[i][index]);
+      for (size_t i = 1; i < total; i++) addbufs<T, f>(first, buffers[i] + begin, length);
 
       // Broadcast back
-      for (size_t i = 1; i < total; i++) buffers[i][index] = first;
+      for (size_t i = 1; i < total; i++) std::copy(first, first + length, buffers[i] + begin);
     }
 
     m_sync->waitForSynchronization();
@@ -277,13 +286,104 @@ private:
   void pass_down(char* buffer, const size_t parent_read_pos, size_t& children_sent_pos);
   void broadcast(char* buffer, const size_t n);
 
+  // Segment i of a ring all_reduce holds elements [i * n / total, (i + 1) * n / total).
+  size_t ring_segment_begin(size_t segment, size_t n) const { return segment * n / total; }
+
+  void ring_init();
+  // Waits until the next node can take more data or the previous node sent some.
+  void ring_wait(bool want_send, bool want_recv, bool& can_send, bool& can_recv);
+  // Both return 0 when the socket is not ready.
+  size_t ring_send(const char* data, size_t length);
+  size_t ring_recv(char* data, size_t length);
+
+  // Bandwidth optimal allreduce: total - 1 reduce-scatter steps followed by total - 1 allgather steps, each moving one
+  // segment to the next node. At step k a node sends segment (node - k) and receives segment (node - k - 1), which is
+  // the one it sends at step k + 1, so sending a step starts as soon as the first elements of the previous step are
+  // received and reduced. Sends, receives and reductions are interleaved in chunks of ar_buf_size over non-blocking
+  // sockets.
+  template <class T, void (*f)(T&, const T&)>
+  void ring_all_reduce(T* buffer, const size_t n)
+  {
+    const size_t steps = 2 * (total - 1);
+    // Segment sent at a step, the segment received at a step is the one sent at the next.
+    auto segment_of_step = [this](size_t step) { return (node + total - step % total) % total; };
+    auto step_begin = [&](size_t step) { return ring_segment_begin(segment_of_step(step), n) * sizeof(T); };
+    auto step_bytes = [&](size_t step) {
+      const size_t segment = segment_of_step(step);
+      return (ring_segment_begin(segment + 1, n) - ring_segment_begin(segment, n)) * sizeof(T);
+    };
+
+    char* data = (char*)buffer;
+    char read_buf[ar_buf_size + sizeof(T) - 1];
+    size_t send_step = 0;
+    size_t sent = 0;  // bytes of send_step already sent
+    size_t recv_step = 0;
+    size_t received = 0;     // bytes of recv_step already reduced into or copied to the buffer
+    size_t unprocessed = 0;  // bytes of a partial element at the start of read_buf
+
+    while (true)
+    {
+      while (send_step < steps && sent == step_bytes(send_step))
+      {
+        send_step++;
+        sent = 0;
+      }
+      while (recv_step < steps && received == step_bytes(recv_step + 1))
+      {
+        recv_step++;
+        received = 0;
+      }
+      if (send_step == steps && recv_step == steps) break;
+
+      // The segment sent at send_step was received at send_step - 1.
+      size_t sendable = 0;
+      if (send_step < steps)
+      {
+        if (send_step == 0 || recv_step >= send_step) { sendable = step_bytes(send_step) - sent; }
+        else if (recv_step == send_step - 1)
+        {
+          sendable = received - sent;
+        }
+      }
+
+      bool can_send = false;
+      bool can_recv = false;
+      ring_wait(sendable > 0, recv_step < steps, can_send, can_recv);
+
+      if (can_send) { sent += ring_send(data + step_begin(send_step) + sent, std::min(ar_buf_size, sendable)); }
+
+      if (can_recv)
+      {
+        const size_t count = std::min(ar_buf_size, step_bytes(recv_step + 1) - received - unprocessed);
+        const size_t available = unprocessed + ring_recv(read_buf + unprocessed, count);
+        const size_t complete = available / sizeof(T) * sizeof(T);
+        T* target = (T*)(data + step_begin(recv_step + 1) + received);
+        if (recv_step < total - 1) { addbufs<T, f>(target, (const T*)read_buf, complete / sizeof(T)); }
+        else
+        {
+          memcpy(target, read_buf, complete);
+        }
+        received += complete;
+        unprocessed = available - complete;
+        for (size_t j = 0; j < unprocessed; j++) read_buf[j] = read_buf[complete + j];
+      }
+    }
+  }
+
   socket_t sock_connect(const uint32_t ip, const int port);
   socket_t getsock();
 
+  AllReduceAlgorithm algorithm;
+  uint32_t local_ip = 0;  // address this node reached the span server from, in network order
+
 public:
   AllReduceSockets(std::string pspan_server, const int pport, const size_t punique_id, size_t ptotal,
-      const size_t pnode, bool pquiet)
-      : AllReduce(ptotal, pnode, pquiet), span_server(pspan_server), port(pport), unique_id(punique_id)
+      const size_t pnode, bool pquiet, AllReduceAlgorithm palgorithm = AllReduceAlgorithm::Tree)
+      : AllReduce(ptotal, pnode, pquiet)
+      , span_server(pspan_server)
+      , port(pport)
+      , unique_id(punique_id)
+      , algorithm(palgorithm)
   {
   }
 
@@ -293,6 +393,12 @@ public:
   void all_reduce(T* buffer, const size_t n)
   {
     if (span_server != socks.current_master) all_reduce_init();
+    if (algorithm == AllReduceAlgorithm::Ring && total > 1)
+    {
+      if (socks.ring_next == -1) ring_init();
+      ring_all_reduce<T, f>(buffer, n);
+      return;
+    }
     reduce<T, f>((char*)buffer, n * sizeof(T));
     broadcast((char*)buffer, n * sizeof(T));
   }
@@ -24,8 +24,10 @@ Alekh Agarwal and John Langford, with help Olivier Chapelle.
 #else
 #  include <unistd.h>
 #  include <arpa/inet.h>
+#  include <fcntl.h>
 #endif
 #include <sys/timeb.h>
+#include <vector>
 #include "allreduce.h"
 #include "vw_exception.h"
 
@@ -33,6 +35,36 @@ Alekh Agarwal and John Langford, with help Olivier Chapelle.
 
 namespace logger = VW::io::logger;
 
+namespace
+{
+void add_address(uint64_t& address, const uint64_t& other) { address += other; }
+
+bool would_block()
+{
+#ifdef _WIN32
+  const int error = WSAGetLastError();
+  return error == WSAEWOULDBLOCK || error == WSAEINTR;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+void set_ring_options(socket_t sock)
+{
+#ifdef _WIN32
+  u_long nonblocking = 1;
+  if (ioctlsocket(sock, FIONBIO, &nonblocking) != 0) THROW("ioctlsocket(FIONBIO) failed: " << WSAGetLastError());
+#else
+  const int flags = fcntl(sock, F_GETFL, 0);
+  if (flags == -1 || fcntl(sock, F_SETFL, flags | O_NONBLOCK) == -1) THROWERRNO("fcntl(O_NONBLOCK)");
+#endif
+  // Chunks are sent as soon as they are reduced, do not wait to fill packets.
+  int nodelay = 1;
+  if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&nodelay, sizeof(nodelay)) < 0)
+  { logger::errlog_error("setsockopt TCP_NODELAY: {}", VW::strerror_to_string(errno)); }
+}
+}  // namespace
+
 // port is already in network order
 socket_t AllReduceSockets::sock_connect(const uint32_t ip, const int port)
 {
@@ -121,6 +153,13 @@ void AllReduceSockets::all_reduce_init()
   uint32_t master_ip = *((uint32_t*)master->h_addr);
 
   socket_t master_sock = sock_connect(master_ip, htons((u_short)port));
+  {
+    // The ring neighbours connect to this node on the address it reaches the span server from.
+    sockaddr_in local_address;
+    socklen_t local_address_size = sizeof(local_address);
+    if (getsockname(master_sock, (sockaddr*)&local_address, &local_address_size) < 0) THROWERRNO("getsockname");
+    local_ip = local_address.sin_addr.s_addr;
+  }
   if (send(master_sock, (const char*)&unique_id, sizeof(unique_id), 0) < (int)sizeof(unique_id))
   { THROW("write unique_id=" << unique_id << " to span server failed"); }
   else
@@ -300,3 +339,91 @@ void AllReduceSockets::broadcast(char* buffer, const size_t n)
     }
   }
 }
+
+void AllReduceSockets::ring_init()
+{
+  socket_t sock = getsock();
+  sockaddr_in address;
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = 0;
+  if (::bind(sock, (sockaddr*)&address, sizeof(address)) < 0) THROWERRNO("bind");
+  if (listen(sock, 1) < 0) THROWERRNO("listen");
+  socklen_t address_size = sizeof(address);
+  if (getsockname(sock, (sockaddr*)&address, &address_size) < 0) THROWERRNO("getsockname");
+
+  // Every node learns the listening address of the others from an all_reduce over the tree.
+  std::vector<uint64_t> addresses(total, 0);
+  addresses[node] = (static_cast<uint64_t>(local_ip) << 16) | address.sin_port;
+  reduce<uint64_t, add_address>((char*)addresses.data(), total * sizeof(uint64_t));
+  broadcast((char*)addresses.data(), total * sizeof(uint64_t));
+
+  // Connecting first cannot deadlock, the connection waits in the backlog of the next node until it accepts.
+  const uint64_t next_address = addresses[(node + 1) % total];
+  socks.ring_next = sock_connect(static_cast<uint32_t>(next_address >> 16), static_cast<int>(next_address & 0xffff));
+  if (send(socks.ring_next, (const char*)&node, sizeof(node), 0) < (int)sizeof(node))
+  { THROW("write node=" << node << " to next node in ring failed"); }
+
+  sockaddr_in prev_address;
+  socklen_t prev_address_size = sizeof(prev_address);
+  socks.ring_prev = accept(sock, (sockaddr*)&prev_address, &prev_address_size);
+#ifdef _WIN32
+  if (socks.ring_prev == INVALID_SOCKET)
+#else
+  if (socks.ring_prev < 0)
+#endif
+    THROWERRNO("accept");
+  CLOSESOCK(sock);
+
+  size_t prev_node;
+  if (recv(socks.ring_prev, (char*)&prev_node, sizeof(prev_node), MSG_WAITALL) < (int)sizeof(prev_node))
+  { THROW("read node from previous node in ring failed"); }
+  if (prev_node != (node + total - 1) % total)
+  { THROW("expected node " << (node + total - 1) % total << " before node " << node << " in ring, got " << prev_node); }
+  logger::errlog_info("connected ring {0} -> {1} -> {2}", prev_node, node, (node + 1) % total);
+
+  set_ring_options(socks.ring_next);
+  set_ring_options(socks.ring_prev);
+}
+
+void AllReduceSockets::ring_wait(bool want_send, bool want_recv, bool& can_send, bool& can_recv)
+{
+  fd_set write_fds;
+  fd_set read_fds;
+  FD_ZERO(&write_fds);
+  FD_ZERO(&read_fds);
+  if (want_send) FD_SET(socks.ring_next, &write_fds);
+  if (want_recv) FD_SET(socks.ring_prev, &read_fds);
+
+  const socket_t max_fd = std::max(socks.ring_next, socks.ring_prev) + 1;
+  if (select((int)max_fd, &read_fds, &write_fds, nullptr, nullptr) == -1)
+  {
+    if (would_block()) return;
+    THROWERRNO("select");
+  }
+  can_send = want_send && FD_ISSET(socks.ring_next, &write_fds);
+  can_recv = want_recv && FD_ISSET(socks.ring_prev, &read_fds);
+}
+
+size_t AllReduceSockets::ring_send(const char* data, size_t length)
+{
+  const int write_size = send(socks.ring_next, data, (int)length, 0);
+  if (write_size < 0)
+  {
+    if (would_block()) return 0;
+    THROWERRNO("send to next node in ring");
+  }
+  return write_size;
+}
+
+size_t AllReduceSockets::ring_recv(char* data, size_t length)
+{
+  const int read_size = recv(socks.ring_prev, data, (int)length, 0);
+  if (read_size == 0) THROW("previous node in ring closed the connection");
+  if (read_size < 0)
+  {
+    if (would_block()) return 0;
+    THROWERRNO("recv from previous node in ring");
+  }
+  return read_size;
+}
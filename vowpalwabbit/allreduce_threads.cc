@@ -7,6 +7,7 @@ This implements the allreduce function using threads.
 */
 #include "allreduce.h"
 #include <future>
+#include <thread>
 
 AllReduceSync::AllReduceSync(const size_t total) : m_total(total), m_count(0), m_run(true)
 {
@@ -20,29 +21,32 @@ AllReduceSync::~AllReduceSync()
 
 void AllReduceSync::waitForSynchronization()
 {
-  std::unique_lock<std::mutex> l(m_mutex);
-  m_count++;
+  // Cannot flip before this thread arrives, and it saw the last flip when it left the previous barrier.
+  const bool current_run = m_run.load(std::memory_order_acquire);
 
-  if (m_count >= m_total)
+  if (m_count.fetch_add(1, std::memory_order_acq_rel) + 1 == m_total)
   {
-    assert(m_count == m_total);
-
+    // Reset before the flip, which releases the others into the next barrier.
+    m_count.store(0, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> l(m_mutex);
+      m_run.store(!current_run, std::memory_order_release);
+    }
     m_cv.notify_all();
-
-    // order of m_count before or after notify_all doesn't matter
-    // since the lock is still hold at this point in time.
-    m_count = 0;
-
-    // flip for the next run
-    m_run = !m_run;
+    return;
   }
-  else
+
+  // The other threads usually arrive within microseconds, so spin before sleeping. Yielding lets threads that
+  // outnumber the cores finish their part.
+  for (size_t i = 0; i < ar_spin_count; i++)
   {
-    bool current_run = m_run;
-    // this predicate cannot depend on m_count, as somebody can race ahead and m_count++
-    // FYI just wait can spuriously wake-up
-    m_cv.wait(l, [this, current_run] { return m_run != current_run; });
+    if (m_run.load(std::memory_order_acquire) != current_run) { return; }
+    std::this_thread::yield();
   }
+
+  std::unique_lock<std::mutex> l(m_mutex);
+  // FYI just wait can spuriously wake-up
+  m_cv.wait(l, [this, current_run] { return m_run.load(std::memory_order_acquire) != current_run; });
 }
 
 AllReduceThreads::AllReduceThreads(AllReduceThreads* root, const size_t ptotal, const size_t pnode, bool pquiet)
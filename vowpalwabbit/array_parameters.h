@@ -208,6 +208,7 @@ public:
   bool normalized;
 
   bool sparse;
+  VW::weight_allocation dense_allocation;  // placement of dense_weights, applied when the regressor is initialized
   dense_parameters dense_weights;
   sparse_parameters sparse_weights;
 
@@ -10,6 +10,7 @@
 #endif
 
 #include "memory.h"
+#include "weight_allocation.h"
 
 typedef float weight;
 
@@ -51,19 +52,23 @@ private:
   uint64_t _weight_mask;  // (stride*(1 << num_bits) -1)
   uint32_t _stride_shift;
   bool _seeded;  // whether the instance is sharing model state with others
+  size_t _mapped_bytes;  // length of the mapping holding the weights, 0 if they are on the heap
 
 public:
   typedef dense_iterator<weight> iterator;
   typedef dense_iterator<const weight> const_iterator;
-  dense_parameters(size_t length, uint32_t stride_shift = 0)
-      : _begin(calloc_mergable_or_throw<weight>(length << stride_shift))
+  dense_parameters(
+      size_t length, uint32_t stride_shift = 0, const VW::weight_allocation& allocation = VW::weight_allocation())
+      : _begin(nullptr)
       , _weight_mask((length << stride_shift) - 1)
       , _stride_shift(stride_shift)
       , _seeded(false)
+      , _mapped_bytes(0)
   {
+    _begin = VW::allocate_weights(length << stride_shift, allocation, _mapped_bytes);
   }
 
-  dense_parameters() : _begin(nullptr), _weight_mask(0), _stride_shift(0), _seeded(false) {}
+  dense_parameters() : _begin(nullptr), _weight_mask(0), _stride_shift(0), _seeded(false), _mapped_bytes(0) {}
 
   bool not_null() { return (_weight_mask > 0 && _begin != nullptr); }
 
@@ -89,7 +94,7 @@ public:
 
   void shallow_copy(const dense_parameters& input)
   {
-    if (!_seeded) free(_begin);
+    if (!_seeded) VW::free_weights(_begin, _mapped_bytes);
     _begin = input._begin;
     _weight_mask = input._weight_mask;
     _stride_shift = input._stride_shift;
@@ -133,8 +138,9 @@ public:
     size_t float_count = length << _stride_shift;
     weight* dest = shared_weights;
     memcpy(dest, _begin, float_count * sizeof(float));
-    free(_begin);
+    VW::free_weights(_begin, _mapped_bytes);
     _begin = dest;
+    _mapped_bytes = float_count * sizeof(float);
   }
 #  endif
 #endif
@@ -143,7 +149,7 @@ public:
   {
     if (_begin != nullptr && !_seeded)  // don't free weight vector if it is shared with another instance
     {
-      free(_begin);
+      VW::free_weights(_begin, _mapped_bytes);
       _begin = nullptr;
     }
   }
@@ -3,10 +3,18 @@
 // license as described in the file LICENSE.
 
 #include "cache.h"
+#include "stream_vbyte.h"
 #include "unique_sort.h"
 #include "global_data.h"
 #include "vw.h"
 
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+#ifdef BUILD_ZSTD
+#  include <zstd.h>
+#endif
+
 constexpr size_t int_size = 11;
 constexpr size_t char_size = 2;
 constexpr size_t neg_1 = 1;
@@ -14,6 +22,15 @@ constexpr size_t general = 2;
 constexpr unsigned char newline_example = '1';
 constexpr unsigned char non_newline_example = '0';
 
+// Namespaces in columnar blocks start with one of these.
+constexpr unsigned char varint_layout = 0;
+constexpr unsigned char columnar_layout = 1;
+// Followed in the columnar layout by how the values are stored.
+constexpr unsigned char unit_values = 0;
+constexpr unsigned char explicit_values = 1;
+// Smaller namespaces gain nothing from the SIMD decoder and are smaller in the varint layout.
+constexpr size_t min_columnar_features = 8;
+
 inline char* run_len_decode(char* p, uint64_t& i)
 {
   // read an int 7 bits at a time.
@@ -61,20 +78,126 @@ __attribute__((packed))
 #endif
 ;
 
+// The varint layout stores no feature count. Each index ends at a byte without the continuation bit, and is followed
+// by a float when it has the general flag and not the -1 one.
+size_t count_varint_features(const char* c, const char* end)
+{
+  size_t count = 0;
+  while (c < end)
+  {
+    const bool has_value = (*c & (neg_1 | general)) == general;
+    while (*c & 128) { c++; }
+    c += has_value ? 1 + sizeof(feature_value) : 1;
+    count++;
+  }
+  return count;
+}
+
+char* read_varint_features(char* c, char* end, features& ours, bool& sorted)
+{
+  uint64_t last = 0;
+  float sum_feat_sq = 0.f;
+
+  const size_t count = count_varint_features(c, end);
+  ours.values.reserve(ours.values.size() + count);
+  ours.indicies.reserve(ours.indicies.size() + count);
+  // Stops at the same feature as the count when a corrupt namespace overruns its end.
+  for (; c < end;)
+  {
+    feature_index i = 0;
+    c = run_len_decode(c, i);
+    feature_value v = 1.f;
+    if (i & neg_1)
+      v = -1.;
+    else if (i & general)
+    {
+      v = ((one_float*)c)->f;
+      c += sizeof(float);
+    }
+    uint64_t diff = i >> 2;
+    int64_t s_diff = ZigZagDecode(diff);
+    if (s_diff < 0) sorted = false;
+    i = last + s_diff;
+    last = i;
+    ours.values.push_back_unchecked(v);
+    ours.indicies.push_back_unchecked(i);
+    sum_feat_sq += v * v;
+  }
+  ours.sum_feat_sq += sum_feat_sq;
+  return c;
+}
+
+// count as uint32_t, value mode, stream vbyte control and data bytes of the zigzag encoded index deltas and then the
+// values as floats unless they are all 1.
+char* read_columnar_features(char* c, char* end, features& ours, bool& sorted)
+{
+  uint32_t count;
+  std::memcpy(&count, c, sizeof(count));
+  c += sizeof(count);
+  const unsigned char value_mode = *c++;
+  const auto* control = reinterpret_cast<const uint8_t*>(c);
+  c += VW::stream_vbyte::control_bytes(count);
+  const char* values = value_mode == explicit_values ? end - count * sizeof(feature_value) : end;
+
+  ours.values.reserve(ours.values.size() + count);
+  ours.indicies.reserve(ours.indicies.size() + count);
+
+  // Decode a batch of deltas at a time, batches are a multiple of 4 so each starts on a control byte.
+  constexpr size_t batch_size = 256;
+  uint32_t deltas[batch_size];
+  uint64_t last = 0;
+  bool decreasing = false;
+  for (size_t done = 0; done < count; done += batch_size)
+  {
+    const size_t n = std::min(batch_size, count - done);
+    c += VW::stream_vbyte::decode(
+        control + done / 4, reinterpret_cast<const uint8_t*>(c), values - c, n, deltas);
+    for (size_t i = 0; i < n; i++)
+    {
+      const int64_t s_diff = ZigZagDecode(deltas[i]);
+      decreasing |= s_diff < 0;
+      last += s_diff;
+      ours.indicies.push_back_unchecked(last);
+    }
+  }
+  if (decreasing) { sorted = false; }
+
+  if (value_mode == explicit_values)
+  {
+    float sum_feat_sq = 0.f;
+    for (uint32_t i = 0; i < count; i++)
+    {
+      feature_value v;
+      std::memcpy(&v, values + i * sizeof(v), sizeof(v));
+      ours.values.push_back_unchecked(v);
+      sum_feat_sq += v * v;
+    }
+    ours.sum_feat_sq += sum_feat_sq;
+  }
+  else
+  {
+    for (uint32_t i = 0; i < count; i++) { ours.values.push_back_unchecked(1.f); }
+    ours.sum_feat_sq += static_cast<float>(count);
+  }
+  return end;
+}
+
 int read_cached_features(vw* all, v_array<example*>& examples)
 {
-  example* ae = examples[0];
-  ae->sorted = all->example_parser->sorted_cache;
-  io_buf* input = all->example_parser->input.get();
+  return read_cached_example(*all, *all->example_parser, *all->example_parser->input, examples[0]);
+}
+
+int read_cached_example(vw& all, parser& p, io_buf& input, example* ae, bool columnar)
+{
+  ae->sorted = p.sorted_cache;
 
-  size_t total = all->example_parser->lbl_parser.read_cached_label(
-      all->example_parser->_shared_data, &ae->l, ae->_reduction_features, *input);
+  size_t total = p.lbl_parser.read_cached_label(p._shared_data, &ae->l, ae->_reduction_features, input);
   if (total == 0) return 0;
-  if (read_cached_tag(*input, ae) == 0) return 0;
+  if (read_cached_tag(input, ae) == 0) return 0;
   char* c;
   // is newline example or not
   unsigned char newline_indicator = 0;
-  if (input->buf_read(c, sizeof(newline_indicator)) < sizeof(newline_indicator)) return 0;
+  if (input.buf_read(c, sizeof(newline_indicator)) < sizeof(newline_indicator)) return 0;
   newline_indicator = *(unsigned char*)c;
   if (newline_indicator == newline_example) { ae->is_newline = true; }
   else
@@ -82,63 +205,50 @@ int read_cached_features(vw* all, v_array<example*>& examples)
     ae->is_newline = false;
   }
   c += sizeof(newline_indicator);
-  all->example_parser->input->set(c);
+  input.set(c);
   // read indices
   unsigned char num_indices = 0;
-  if (input->buf_read(c, sizeof(num_indices)) < sizeof(num_indices)) return 0;
+  if (input.buf_read(c, sizeof(num_indices)) < sizeof(num_indices)) return 0;
   num_indices = *(unsigned char*)c;
   c += sizeof(num_indices);
 
-  all->example_parser->input->set(c);
+  input.set(c);
   for (; num_indices > 0; num_indices--)
   {
     size_t temp;
     unsigned char index = 0;
-    if ((temp = input->buf_read(c, sizeof(index) + sizeof(size_t))) < sizeof(index) + sizeof(size_t))
+    if ((temp = input.buf_read(c, sizeof(index) + sizeof(size_t))) < sizeof(index) + sizeof(size_t))
     {
-      *(all->trace_message) << "truncated example! " << temp << " " << char_size + sizeof(size_t) << std::endl;
+      *(all.trace_message) << "truncated example! " << temp << " " << char_size + sizeof(size_t) << std::endl;
       return 0;
     }
 
     index = *(unsigned char*)c;
     c += sizeof(index);
 
-    ae->indices.push_back((size_t)index);
-    features& ours = ae->feature_space[index];
     size_t storage = *(size_t*)c;
     c += sizeof(size_t);
-    all->example_parser->input->set(c);
+    input.set(c);
     total += storage;
-    if (input->buf_read(c, storage) < storage)
+    if (input.buf_read(c, storage) < storage)
     {
-      *(all->trace_message) << "truncated example! wanted: " << storage << " bytes" << std::endl;
+      *(all.trace_message) << "truncated example! wanted: " << storage << " bytes" << std::endl;
       return 0;
     }
 
-    char* end = c + storage;
+    // setup_example would drop the namespace anyway, so there is no point in decoding it.
+    if (all.ignore_some && all.ignore[index]) { continue; }
 
-    uint64_t last = 0;
+    ae->indices.push_back((size_t)index);
+    features& ours = ae->feature_space[index];
+    char* end = c + storage;
 
-    for (; c != end;)
+    if (columnar && *c++ == columnar_layout) { c = read_columnar_features(c, end, ours, ae->sorted); }
+    else
     {
-      feature_index i = 0;
-      c = run_len_decode(c, i);
-      feature_value v = 1.f;
-      if (i & neg_1)
-        v = -1.;
-      else if (i & general)
-      {
-        v = ((one_float*)c)->f;
-        c += sizeof(float);
-      }
-      uint64_t diff = i >> 2;
-      int64_t s_diff = ZigZagDecode(diff);
-      if (s_diff < 0) ae->sorted = false;
-      i = last + s_diff;
-      last = i;
-      ours.push_back(v, i);
+      c = read_varint_features(c, end, ours, ae->sorted);
     }
-    all->example_parser->input->set(c);
+    input.set(c);
   }
 
   return (int)total;
@@ -159,20 +269,8 @@ void output_byte(io_buf& cache, unsigned char s)
   cache.set(c);
 }
 
-void output_features(io_buf& cache, unsigned char index, features& fs, uint64_t mask)
+char* write_varint_features(char* c, features& fs, uint64_t mask)
 {
-  char* c;
-  size_t storage = fs.size() * int_size;
-  for (feature_value f : fs.values)
-    if (f != 1. && f != -1.) storage += sizeof(feature_value);
-
-  cache.buf_write(c, sizeof(index) + storage + sizeof(size_t));
-  *reinterpret_cast<unsigned char*>(c) = index;
-  c += sizeof(index);
-
-  char* storage_size_loc = c;
-  c += sizeof(size_t);
-
   uint64_t last = 0;
   for (features::iterator& f : fs)
   {
@@ -192,6 +290,92 @@ void output_features(io_buf& cache, unsigned char index, features& fs, uint64_t
       c += sizeof(feature_value);
     }
   }
+  return c;
+}
+
+size_t varint_storage(features& fs)
+{
+  size_t storage = fs.size() * int_size;
+  for (feature_value f : fs.values)
+    if (f != 1. && f != -1.) storage += sizeof(feature_value);
+  return storage;
+}
+
+void output_features(io_buf& cache, unsigned char index, features& fs, uint64_t mask)
+{
+  char* c;
+  cache.buf_write(c, sizeof(index) + varint_storage(fs) + sizeof(size_t));
+  *reinterpret_cast<unsigned char*>(c) = index;
+  c += sizeof(index);
+
+  char* storage_size_loc = c;
+  c += sizeof(size_t);
+
+  c = write_varint_features(c, fs, mask);
+
+  cache.set(c);
+  *(size_t*)storage_size_loc = c - storage_size_loc - sizeof(size_t);
+}
+
+void output_columnar_features(
+    io_buf& cache, unsigned char index, features& fs, uint64_t mask, std::vector<uint32_t>& deltas)
+{
+  deltas.clear();
+  bool columnar = true;
+  bool unit = true;
+  uint64_t last = 0;
+  for (features::iterator& f : fs)
+  {
+    feature_index fi = f.index() & mask;
+    uint64_t diff = ZigZagEncode(fi - last);
+    last = fi;
+    columnar &= diff <= UINT32_MAX;
+    unit &= f.value() == 1.f;
+    deltas.push_back(static_cast<uint32_t>(diff));
+  }
+  const size_t count = deltas.size();
+  columnar &= count >= min_columnar_features && count <= UINT32_MAX;
+
+  size_t storage = 1;
+  if (columnar)
+  {
+    storage += sizeof(uint32_t) + 1 + VW::stream_vbyte::control_bytes(count) +
+        VW::stream_vbyte::max_data_bytes(count) + (unit ? 0 : count * sizeof(feature_value));
+  }
+  else
+  {
+    storage += varint_storage(fs);
+  }
+
+  char* c;
+  cache.buf_write(c, sizeof(index) + storage + sizeof(size_t));
+  *reinterpret_cast<unsigned char*>(c) = index;
+  c += sizeof(index);
+
+  char* storage_size_loc = c;
+  c += sizeof(size_t);
+
+  if (columnar)
+  {
+    *c++ = columnar_layout;
+    const auto count32 = static_cast<uint32_t>(count);
+    std::memcpy(c, &count32, sizeof(count32));
+    c += sizeof(count32);
+    *c++ = unit ? unit_values : explicit_values;
+    auto* control = reinterpret_cast<uint8_t*>(c);
+    c += VW::stream_vbyte::control_bytes(count);
+    c += VW::stream_vbyte::encode(deltas.data(), count, control, reinterpret_cast<uint8_t*>(c));
+    if (!unit)
+    {
+      std::memcpy(c, fs.values.begin(), count * sizeof(feature_value));
+      c += count * sizeof(feature_value);
+    }
+  }
+  else
+  {
+    *c++ = varint_layout;
+    c = write_varint_features(c, fs, mask);
+  }
 
   cache.set(c);
   *(size_t*)storage_size_loc = c - storage_size_loc - sizeof(size_t);
@@ -208,7 +392,7 @@ void cache_tag(io_buf& cache, const v_array<char>& tag)
   cache.set(c);
 }
 
-void cache_features(io_buf& cache, example* ae, uint64_t mask)
+void cache_example_header(io_buf& cache, example* ae)
 {
   cache_tag(cache, ae->tag);
 
@@ -218,12 +402,229 @@ void cache_features(io_buf& cache, example* ae, uint64_t mask)
     output_byte(cache, non_newline_example);
   }
   output_byte(cache, (unsigned char)ae->indices.size());
+}
 
+void cache_features(io_buf& cache, example* ae, uint64_t mask)
+{
+  cache_example_header(cache, ae);
   for (namespace_index ns : ae->indices) output_features(cache, ns, ae->feature_space[ns], mask);
 }
 
-uint32_t VW::convert(size_t number)
+void cache_columnar_features(io_buf& cache, example* ae, uint64_t mask, std::vector<uint32_t>& deltas)
+{
+  cache_example_header(cache, ae);
+  for (namespace_index ns : ae->indices) output_columnar_features(cache, ns, ae->feature_space[ns], mask, deltas);
+}
+
+namespace VW
+{
+uint32_t convert(size_t number)
 {
   if (number > UINT32_MAX) { THROW("size_t value is out of bounds of uint32_t.") }
   return static_cast<uint32_t>(number);
 }
+
+cache_block_writer::cache_block_writer(size_t examples_per_block, cache_block_compression compression)
+    : _examples_per_block(examples_per_block)
+    , _compression(compression)
+    , _payload(std::make_shared<std::vector<char>>())
+{
+  _block.add_file(VW::io::create_vector_writer(_payload));
+}
+
+void cache_block_writer::write(vw& all, example* ae, io_buf& output)
+{
+  _offsets.push_back(_payload->size() + _block.unflushed_bytes_count());
+  all.example_parser->lbl_parser.cache_label(&ae->l, ae->_reduction_features, _block);
+  cache_columnar_features(_block, ae, all.parse_mask, _deltas);
+  if (_offsets.size() >= _examples_per_block ||
+      _payload->size() + _block.unflushed_bytes_count() >= cache_block_header::MAX_PAYLOAD_BYTES / 2)
+  { flush(output); }
+}
+
+void cache_block_writer::flush(io_buf& output)
+{
+  if (_offsets.empty()) { return; }
+  _block.flush();
+
+  cache_block_header header;
+  header.num_examples = convert(_offsets.size());
+  header.flags = cache_block_header::COLUMNAR_FEATURES;
+  header.payload_bytes = _payload->size();
+  header.stored_bytes = _payload->size();
+  const char* stored = _payload->data();
+  if (_compression == cache_block_compression::zlib)
+  {
+    uLongf compressed_size = compressBound(static_cast<uLong>(_payload->size()));
+    _compressed.resize(compressed_size);
+    if (compress2(reinterpret_cast<Bytef*>(_compressed.data()), &compressed_size,
+            reinterpret_cast<const Bytef*>(_payload->data()), static_cast<uLong>(_payload->size()),
+            Z_BEST_SPEED) != Z_OK)
+    { THROW("failed to compress cache block"); }
+    header.flags |= cache_block_header::COMPRESSED;
+    header.stored_bytes = compressed_size;
+    stored = _compressed.data();
+  }
+#ifdef BUILD_ZSTD
+  else if (_compression == cache_block_compression::zstd)
+  {
+    _compressed.resize(ZSTD_compressBound(_payload->size()));
+    const size_t compressed_size =
+        ZSTD_compress(_compressed.data(), _compressed.size(), _payload->data(), _payload->size(), 1);
+    if (ZSTD_isError(compressed_size))
+    { THROW("failed to compress cache block: " << ZSTD_getErrorName(compressed_size)); }
+    header.flags |= cache_block_header::ZSTD_COMPRESSED;
+    header.stored_bytes = compressed_size;
+    stored = _compressed.data();
+  }
+#endif
+
+  output.bin_write_fixed(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.bin_write_fixed(reinterpret_cast<const char*>(_offsets.data()), _offsets.size() * sizeof(uint64_t));
+  output.bin_write_fixed(stored, header.stored_bytes);
+
+  _payload->clear();
+  _offsets.clear();
+}
+
+namespace
+{
+// Lets io_buf read a decoded block payload in place instead of copying it.
+class payload_reader : public VW::io::reader
+{
+public:
+  payload_reader(char* data, size_t len) : reader(false /*is_resettable*/), _data(data), _len(len) {}
+
+  ssize_t read(char* buffer, size_t num_bytes) override
+  {
+    num_bytes = std::min(num_bytes, _len);
+    std::memcpy(buffer, _data, num_bytes);
+    _data += num_bytes;
+    _len -= num_bytes;
+    return static_cast<ssize_t>(num_bytes);
+  }
+
+  bool read_in_place(char*& data, size_t& len) override
+  {
+    data = _data;
+    len = _len;
+    _data += _len;
+    _len = 0;
+    return true;
+  }
+
+private:
+  char* _data;
+  size_t _len;
+};
+
+// The sizes in the header are used to allocate the block, so they are checked before anything is read.
+void check_header(const cache_block_header& header)
+{
+  const uint32_t known_flags =
+      cache_block_header::COMPRESSED | cache_block_header::COLUMNAR_FEATURES | cache_block_header::ZSTD_COMPRESSED;
+  const bool compressed = (header.flags & (cache_block_header::COMPRESSED | cache_block_header::ZSTD_COMPRESSED)) != 0;
+  // Every example takes at least one byte, and neither zlib nor zstd grow their input by more than this.
+  const uint64_t max_stored_bytes = header.payload_bytes + header.payload_bytes / 64 + 1024;
+  if ((header.flags & ~known_flags) != 0 || header.num_examples == 0 || header.num_examples > header.payload_bytes ||
+      header.payload_bytes > cache_block_header::MAX_PAYLOAD_BYTES || header.stored_bytes > max_stored_bytes ||
+      (!compressed && header.stored_bytes != header.payload_bytes))
+  {
+    THROW("cache block header is corrupt: " << header.num_examples << " examples, flags " << header.flags << ", "
+                                            << header.stored_bytes << " stored and " << header.payload_bytes
+                                            << " payload bytes");
+  }
+}
+
+class cache_block_input_format : public parallel_parser::input_format
+{
+public:
+  void read_chunk(vw& all, parallel_parser::chunk& c) override
+  {
+    io_buf& input = *all.example_parser->input;
+    char* p;
+    size_t read = input.buf_read(p, sizeof(cache_block_header));
+    if (read == 0) { return; }
+    if (read < sizeof(cache_block_header))
+    {
+      *(all.trace_message) << "truncated cache block header!" << std::endl;
+      return;
+    }
+
+    cache_block_header header;
+    std::memcpy(&header, p, sizeof(header));
+    check_header(header);
+    const size_t offsets_size = header.num_examples * sizeof(uint64_t);
+    c.data.resize(sizeof(header) + offsets_size + header.stored_bytes);
+    std::memcpy(c.data.data(), &header, sizeof(header));
+    if (input.bin_read_fixed(c.data.data() + sizeof(header), offsets_size, "") < offsets_size ||
+        input.bin_read_fixed(c.data.data() + sizeof(header) + offsets_size, header.stored_bytes, "") <
+            header.stored_bytes)
+    {
+      *(all.trace_message) << "truncated cache block! wanted: " << header.stored_bytes << " bytes" << std::endl;
+      c.data.clear();
+      return;
+    }
+
+    const auto* offsets = reinterpret_cast<const uint64_t*>(c.data.data() + sizeof(header));
+    for (uint32_t i = 0; i < header.num_examples; i++)
+    {
+      const uint64_t next = i + 1 < header.num_examples ? offsets[i + 1] : header.payload_bytes;
+      if (next <= offsets[i] || next > header.payload_bytes) THROW("cache block has invalid example offsets");
+      c.offsets.push_back(offsets[i]);
+      c.lengths.push_back(next - offsets[i]);
+      c.consumed.push_back(next - offsets[i]);
+    }
+  }
+
+  void parse_chunk(vw& all, parallel_parser::chunk& c, parser& scratch) override
+  {
+    cache_block_header header;
+    std::memcpy(&header, c.data.data(), sizeof(header));
+    char* payload = c.data.data() + sizeof(header) + header.num_examples * sizeof(uint64_t);
+
+    std::vector<char> uncompressed;
+    if (header.flags & cache_block_header::COMPRESSED)
+    {
+      uncompressed.resize(header.payload_bytes);
+      uLongf uncompressed_size = static_cast<uLongf>(header.payload_bytes);
+      if (uncompress(reinterpret_cast<Bytef*>(uncompressed.data()), &uncompressed_size,
+              reinterpret_cast<const Bytef*>(payload), static_cast<uLong>(header.stored_bytes)) != Z_OK ||
+          uncompressed_size != header.payload_bytes)
+      { THROW("failed to decompress cache block"); }
+      payload = uncompressed.data();
+    }
+    else if (header.flags & cache_block_header::ZSTD_COMPRESSED)
+    {
+#ifdef BUILD_ZSTD
+      uncompressed.resize(header.payload_bytes);
+      const size_t uncompressed_size =
+          ZSTD_decompress(uncompressed.data(), uncompressed.size(), payload, static_cast<size_t>(header.stored_bytes));
+      if (ZSTD_isError(uncompressed_size) || uncompressed_size != header.payload_bytes)
+      { THROW("failed to decompress cache block"); }
+      payload = uncompressed.data();
+#else
+      THROW("cache file is zstd compressed, VW has to be built with BUILD_ZSTD to read it");
+#endif
+    }
+
+    const bool columnar = (header.flags & cache_block_header::COLUMNAR_FEATURES) != 0;
+    io_buf& input = *scratch.input;
+    input.close_files();
+    input.reset_buffer();
+    input.current = 0;
+    input.add_file(VW::make_unique<payload_reader>(payload, header.payload_bytes));
+    for (; c.num_parsed < c.examples.size(); c.num_parsed++)
+    {
+      if (read_cached_example(all, scratch, input, c.examples[c.num_parsed], columnar) == 0)
+      { THROW("cache block is corrupt, example " << c.first_example_index + c.num_parsed << " could not be read"); }
+    }
+  }
+};
+}  // namespace
+
+std::unique_ptr<parallel_parser::input_format> make_cache_block_input_format()
+{
+  return VW::make_unique<cache_block_input_format>();
+}
+}  // namespace VW
@@ -3,20 +3,93 @@
 // license as described in the file LICENSE.
 
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "v_array.h"
 #include "io_buf.h"
 #include "example.h"
+#include "parallel_parser.h"
+
+struct parser;
+
+// Marks the format in the cache file header, right after the version.
+constexpr char stream_cache_marker = 'c';
+constexpr char block_cache_marker = 'b';
 
 char* run_len_decode(char* p, size_t& i);
 char* run_len_encode(char* p, size_t i);
 
 int read_cached_features(vw* all, v_array<example*>& examples);
+// Reads a single cached example from input using the label parser of p. Namespaces ignored by all are skipped without
+// being decoded. columnar must be set for examples from blocks with the COLUMNAR_FEATURES flag. Returns 0 if the input
+// is exhausted or truncated.
+int read_cached_example(vw& all, parser& p, io_buf& input, example* ae, bool columnar = false);
 void cache_tag(io_buf& cache, const v_array<char>& tag);
 void cache_features(io_buf& cache, example* ae, uint64_t mask);
+// Same as cache_features but writes the namespaces in the layout of COLUMNAR_FEATURES blocks. deltas is scratch space.
+void cache_columnar_features(io_buf& cache, example* ae, uint64_t mask, std::vector<uint32_t>& deltas);
 void output_byte(io_buf& cache, unsigned char s);
 void output_features(io_buf& cache, unsigned char index, features& fs, uint64_t mask);
 
 namespace VW
 {
 uint32_t convert(size_t number);
-}
+
+/*
+ * Block format caches group the examples into blocks which start with a cache_block_header, followed by the offset of
+ * each example within the payload as uint64_t and then the payload itself. The payload holds the examples in the same
+ * encoding as the stream format and is zlib or zstd compressed if the header says so. Blocks can be skipped or decoded
+ * independently of each other.
+ *
+ * In blocks with the COLUMNAR_FEATURES flag every namespace starts with a layout byte. The columnar layout stores the
+ * index deltas with stream_vbyte, which decodes four at a time, and the values separately so the common all 1 case
+ * takes no space. Namespaces with deltas that do not fit 32 bits fall back to the stream encoding.
+ */
+struct cache_block_header
+{
+  static constexpr uint32_t COMPRESSED = 1;
+  static constexpr uint32_t COLUMNAR_FEATURES = 2;
+  static constexpr uint32_t ZSTD_COMPRESSED = 4;
+  // Readers reject larger blocks as corrupt, writers start a new block well before reaching it.
+  static constexpr uint64_t MAX_PAYLOAD_BYTES = uint64_t(1) << 30;
+
+  uint32_t num_examples;
+  uint32_t flags;
+  uint64_t stored_bytes;
+  uint64_t payload_bytes;
+};
+static_assert(sizeof(cache_block_header) == 24, "cache_block_header is written to disk as is");
+
+enum class cache_block_compression
+{
+  none,
+  zlib,
+  zstd
+};
+
+class cache_block_writer
+{
+public:
+  cache_block_writer(size_t examples_per_block, cache_block_compression compression);
+
+  // Caches the label and features of ae. The current block is written to output once it is full.
+  void write(vw& all, example* ae, io_buf& output);
+
+  // Writes out the current block if it holds any examples.
+  void flush(io_buf& output);
+
+private:
+  size_t _examples_per_block;
+  cache_block_compression _compression;
+  std::shared_ptr<std::vector<char>> _payload;
+  io_buf _block;
+  std::vector<uint64_t> _offsets;
+  std::vector<char> _compressed;
+  std::vector<uint32_t> _deltas;
+};
+
+// Reads block format caches for parallel_parser, one block per chunk.
+std::unique_ptr<parallel_parser::input_format> make_cache_block_input_format();
+}  // namespace VW
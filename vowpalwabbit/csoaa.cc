@@ -14,6 +14,7 @@
 #include "csoaa.h"
 #include "scope_exit.h"
 #include "shared_data.h"
+#include "worker_pool.h"
 
 #include "io/logger.h"
 
@@ -173,6 +174,9 @@ struct ldf
   uint64_t ft_offset;
 
   std::vector<action_scores> stored_preds;
+
+  // Scores the actions of a prediction on several threads, set with --ldf_predict_threads.
+  std::unique_ptr<VW::worker_pool> predict_pool;
 };
 
 bool ec_is_label_definition(example& ec)  // label defs look like "0:___" or just "label:___"
@@ -275,6 +279,27 @@ void make_single_prediction(ldf& data, single_learner& base, example& ec)
   base.predict(ec);  // make a prediction
 }
 
+// Waking the workers costs more than scoring a handful of actions, so small multiline examples are scored on the calling
+// thread alone.
+constexpr size_t MIN_ACTIONS_PER_THREAD = 8;
+
+// Each action is only read and written by the thread scoring it, and below csoaa_ldf only gd and scorer are allowed
+// with the pool, which do nothing but read the weights when predicting.
+void make_predictions(ldf& data, single_learner& base, multi_ex& ec_seq)
+{
+  if (!data.predict_pool || ec_seq.size() < data.predict_pool->num_threads() * MIN_ACTIONS_PER_THREAD)
+  {
+    for (auto* ec : ec_seq) { make_single_prediction(data, base, *ec); }
+    return;
+  }
+
+  // The first action is scored before the others are handed out, so that whatever the base computes on the first
+  // prediction of a multiline example and reuses after, like the shared score of --factorize_shared, is in place.
+  make_single_prediction(data, base, *ec_seq[0]);
+  data.predict_pool->for_each(ec_seq.size() - 1,
+      [&data, &base, &ec_seq](size_t i, size_t) { make_single_prediction(data, base, *ec_seq[i + 1]); });
+}
+
 bool test_ldf_sequence(ldf& data, multi_ex& ec_seq)
 {
   bool isTest;
@@ -505,11 +530,11 @@ void predict_csoaa_ldf(ldf& data, single_learner& base, multi_ex& ec_seq_all)
   });
 
   /////////////////////// do prediction
+  make_predictions(data, base, ec_seq);
   float min_score = FLT_MAX;
   for (uint32_t k = 0; k < K; k++)
   {
     example* ec = ec_seq[k];
-    make_single_prediction(data, base, *ec);
     if (ec->partial_prediction < min_score)
     {
       min_score = ec->partial_prediction;
@@ -550,11 +575,11 @@ void predict_csoaa_ldf_rank(ldf& data, single_learner& base, multi_ex& ec_seq_al
     if (data.is_probabilities) { convert_to_probabilities(ec_seq); }
   });
 
+  for (auto* ec : ec_seq) { data.stored_preds.emplace_back(std::move(ec->pred.a_s)); }
+  make_predictions(data, base, ec_seq);
   for (uint32_t k = 0; k < K; k++)
   {
     example* ec = ec_seq[k];
-    data.stored_preds.emplace_back(std::move(ec->pred.a_s));
-    make_single_prediction(data, base, *ec);
     action_score s;
     s.score = ec->partial_prediction;
     s.action = k;
@@ -822,6 +847,7 @@ base_learner* csldf_setup(options_i& options, vw& all)
   std::string csoaa_ldf;
   std::string ldf_override;
   std::string wap_ldf;
+  uint64_t predict_threads = 1;
 
   option_group_definition csldf_outer_options("Cost Sensitive One Against All with Label Dependent Features");
   csldf_outer_options.add(make_option("csoaa_ldf", csoaa_ldf)
@@ -834,6 +860,10 @@ base_learner* csldf_setup(options_i& options, vw& all)
   csldf_outer_options.add(make_option("csoaa_rank", ld->rank).keep().help("Return actions sorted by score order"));
   csldf_outer_options.add(
       make_option("probabilities", ld->is_probabilities).keep().help("predict probabilites of all classes"));
+  csldf_outer_options.add(make_option("ldf_predict_threads", predict_threads)
+                              .default_value(1)
+                              .help("Number of threads scoring the actions of a multiline example when predicting. Only "
+                                    "for gd with dense weights."));
 
   option_group_definition csldf_inner_options("Cost Sensitive weighted all-pairs with Label Dependent Features");
   csldf_inner_options.add(make_option("wap_ldf", wap_ldf)
@@ -898,6 +928,22 @@ base_learner* csldf_setup(options_i& options, vw& all)
 
   ld->read_example_this_loop = 0;
   single_learner* pbase = as_singleline(setup_base(*all.options, all));
+
+  if (predict_threads == 0) { THROW("ldf_predict_threads should be positive"); }
+  if (predict_threads > 1)
+  {
+    static const std::vector<std::string> concurrent_predict_reductions = {"gd", "scorer"};
+    for (const auto& reduction : all.enabled_reductions)
+    {
+      if (std::find(concurrent_predict_reductions.begin(), concurrent_predict_reductions.end(), reduction) ==
+          concurrent_predict_reductions.end())
+      { THROW("--ldf_predict_threads does not support the " << reduction << " reduction"); }
+    }
+    // Reading a missing sparse weight inserts it.
+    if (all.weights.sparse) { THROW("--ldf_predict_threads cannot be used with --sparse_weights"); }
+    if (all.audit || all.hash_inv) { THROW("--ldf_predict_threads cannot be used with --audit or --invert_hash"); }
+    ld->predict_pool = VW::make_unique<VW::worker_pool>(predict_threads);
+  }
   learner<ldf, multi_ex>* pl = nullptr;
 
   std::string name = all.get_setupfn_name(csldf_setup);
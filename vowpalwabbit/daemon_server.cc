@@ -0,0 +1,604 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "daemon_server.h"
+
+#include "global_data.h"
+#include "vw_exception.h"
+
+#if defined(__linux__)
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#  include <sys/socket.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+
+#  include <algorithm>
+#  include <atomic>
+#  include <cerrno>
+#  include <csignal>
+#  include <cstring>
+#  include <condition_variable>
+#  include <deque>
+#  include <map>
+#  include <mutex>
+#  include <string>
+#  include <thread>
+#  include <unordered_map>
+#  include <vector>
+
+#  include "learner.h"
+#  include "parse_example.h"
+#  include "parser.h"
+#  include "shared_data.h"
+#  include "vw.h"
+#  include "io/logger.h"
+
+namespace logger = VW::io::logger;
+
+namespace
+{
+// Requests of one connection that may be queued or in progress before it stops being read.
+constexpr size_t max_requests_in_flight = 64;
+constexpr size_t read_size = 64 * 1024;
+// Input of one connection that may wait for the end of its line, or of its multi_ex, before the connection is dropped.
+constexpr size_t max_pending_input = 64 * 1024 * 1024;
+constexpr int max_events = 256;
+
+// Set by SIGTERM, which also wakes up the event thread through wakeup_fd.
+std::atomic<bool> got_sigterm{false};
+int sigterm_wakeup_fd = -1;
+
+void handle_sigterm(int)
+{
+  got_sigterm = true;
+  if (sigterm_wakeup_fd >= 0)
+  {
+    uint64_t one = 1;
+    ssize_t ignored = write(sigterm_wakeup_fd, &one, sizeof(one));
+    (void)ignored;
+  }
+}
+
+bool is_empty_line(const char* begin, const char* end) { return begin == end || (end - begin == 1 && *begin == '\r'); }
+}  // namespace
+
+namespace VW
+{
+struct daemon_server::impl
+{
+  struct connection
+  {
+    int fd;
+    // Read and not yet part of a request, and the offset up to which it was searched for a cut. Event thread only.
+    std::string input;
+    size_t scanned = 0;
+    uint64_t next_request = 0;
+
+    std::mutex lock;
+    bool read_closed = false;
+    bool broken = false;
+    bool retired = false;
+    bool registered = false;
+    uint32_t events = 0;
+    size_t in_flight = 0;
+    // Responses that finished before an earlier request of the connection, by request number.
+    std::map<uint64_t, std::string> finished;
+    uint64_t next_response = 0;
+    std::string output;
+    size_t output_sent = 0;
+
+    explicit connection(int f) : fd(f) {}
+  };
+
+  struct request
+  {
+    std::shared_ptr<connection> conn;
+    uint64_t id;
+    std::string text;
+  };
+
+  struct worker
+  {
+    vw* model;
+    bool owns_model;
+    std::unique_ptr<shared_data> sd;
+    std::shared_ptr<std::vector<char>> predictions;
+    std::thread thread;
+  };
+
+  vw& all;
+  int listen_fd;
+  size_t num_workers;
+  bool json;
+  bool multiline;
+
+  int epoll_fd = -1;
+  int wakeup_fd = -1;
+  std::atomic<bool> stopping{false};
+  std::unordered_map<int, std::shared_ptr<connection>> connections;
+
+  std::mutex retired_lock;
+  std::vector<std::shared_ptr<connection>> retired;
+
+  std::mutex queue_lock;
+  std::condition_variable queue_cv;
+  std::deque<request> queue;
+  bool queue_done = false;
+
+  std::vector<worker> workers;
+
+  impl(vw& a, int fd, size_t n) : all(a), listen_fd(fd), num_workers(n), json(false), multiline(false) {}
+
+  void wake()
+  {
+    if (wakeup_fd < 0) { return; }
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeup_fd, &one, sizeof(one));
+    (void)ignored;
+  }
+
+  // Registers for the events the connection currently needs. A connection that needs none is removed from the epoll
+  // set, as a peer that closed its side would otherwise keep reporting EPOLLHUP.
+  void update_events_locked(const std::shared_ptr<connection>& conn)
+  {
+    connection& c = *conn;
+    if (c.retired) { return; }
+    uint32_t wanted = 0;
+    if (!c.read_closed && c.in_flight < max_requests_in_flight) { wanted |= EPOLLIN; }
+    if (c.output_sent < c.output.size()) { wanted |= EPOLLOUT; }
+
+    if (wanted == 0)
+    {
+      if (c.registered) { epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr); }
+      c.registered = false;
+    }
+    else if (!c.registered || wanted != c.events)
+    {
+      epoll_event ev{};
+      ev.events = wanted;
+      ev.data.fd = c.fd;
+      if (epoll_ctl(epoll_fd, c.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, c.fd, &ev) != 0)
+      { THROWERRNO("epoll_ctl on a daemon connection"); }
+      c.registered = true;
+    }
+    c.events = wanted;
+
+    if (c.read_closed && c.in_flight == 0 && c.output_sent == c.output.size())
+    {
+      // Only the event thread closes descriptors, so that a number is not reused while still in the connection map.
+      c.retired = true;
+      if (c.registered) { epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c.fd, nullptr); }
+      c.registered = false;
+      std::lock_guard<std::mutex> lock(retired_lock);
+      retired.push_back(conn);
+      wake();
+    }
+  }
+
+  void flush_locked(connection& c)
+  {
+    while (!c.broken && c.output_sent < c.output.size())
+    {
+      ssize_t sent =
+          send(c.fd, c.output.data() + c.output_sent, c.output.size() - c.output_sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+      if (sent > 0) { c.output_sent += sent; }
+      else if (sent < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        return;
+      }
+      else
+      {
+        // The client went away, its remaining predictions are dropped.
+        c.broken = true;
+        c.read_closed = true;
+      }
+    }
+    c.output.clear();
+    c.output_sent = 0;
+  }
+
+  void complete(const std::shared_ptr<connection>& conn, uint64_t id, std::string response)
+  {
+    std::lock_guard<std::mutex> lock(conn->lock);
+    conn->in_flight--;
+    if (!conn->broken)
+    {
+      conn->finished.emplace(id, std::move(response));
+      for (auto it = conn->finished.begin(); it != conn->finished.end() && it->first == conn->next_response;
+           it = conn->finished.erase(it))
+      {
+        conn->output += it->second;
+        conn->next_response++;
+      }
+      flush_locked(*conn);
+    }
+    update_events_locked(conn);
+  }
+
+  // Cuts the complete part of the input into a request. At the end of the input everything left is part of it.
+  void cut_request(const std::shared_ptr<connection>& conn, bool at_end)
+  {
+    std::string& input = conn->input;
+    size_t cut = 0;
+    if (at_end) { cut = input.size(); }
+    else if (multiline && !json)
+    {
+      // After the last empty line, so that each multi_ex is in one request.
+      size_t line_begin = conn->scanned;
+      for (size_t pos = input.find('\n', line_begin); pos != std::string::npos; pos = input.find('\n', line_begin))
+      {
+        if (is_empty_line(input.data() + line_begin, input.data() + pos)) { cut = pos + 1; }
+        line_begin = pos + 1;
+      }
+      conn->scanned = line_begin;
+    }
+    else
+    {
+      const size_t last_newline = input.rfind('\n');
+      if (last_newline != std::string::npos) { cut = last_newline + 1; }
+    }
+    if (cut == 0) { return; }
+
+    request r{conn, conn->next_request++, input.substr(0, cut)};
+    input.erase(0, cut);
+    conn->scanned = conn->scanned > cut ? conn->scanned - cut : 0;
+    {
+      std::lock_guard<std::mutex> lock(conn->lock);
+      conn->in_flight++;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queue_lock);
+      queue.push_back(std::move(r));
+    }
+    queue_cv.notify_one();
+  }
+
+  void on_readable(const std::shared_ptr<connection>& conn)
+  {
+    {
+      // A worker may have given up on the connection since the event was reported.
+      std::lock_guard<std::mutex> lock(conn->lock);
+      if (conn->read_closed) { return; }
+    }
+    char buffer[read_size];
+    bool at_end = false;
+    while (true)
+    {
+      ssize_t received = recv(conn->fd, buffer, sizeof(buffer), 0);
+      if (received > 0)
+      {
+        conn->input.append(buffer, received);
+        // Leave the rest in the socket so that one connection cannot starve the others.
+        if (static_cast<size_t>(received) < sizeof(buffer) || conn->input.size() >= 16 * read_size) { break; }
+      }
+      else if (received < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        break;
+      }
+      else
+      {
+        at_end = true;
+        break;
+      }
+    }
+
+    if (!conn->input.empty()) { cut_request(conn, at_end); }
+    std::lock_guard<std::mutex> lock(conn->lock);
+    conn->read_closed |= at_end;
+    if (conn->input.size() > max_pending_input)
+    {
+      logger::log_error("daemon connection sent more than {} bytes without completing an example, closing it",
+          max_pending_input);
+      conn->input.clear();
+      conn->input.shrink_to_fit();
+      conn->broken = true;
+      conn->read_closed = true;
+    }
+    update_events_locked(conn);
+  }
+
+  void accept_connections()
+  {
+    while (true)
+    {
+      sockaddr_in client_address;
+      socklen_t size = sizeof(client_address);
+      int fd = accept4(listen_fd, reinterpret_cast<sockaddr*>(&client_address), &size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0)
+      {
+        if (errno == EINTR || errno == ECONNABORTED) { continue; }
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        { logger::log_warn("daemon accept: {}", VW::strerror_to_string(errno)); }
+        return;
+      }
+
+      // Disable Nagle delay algorithm due to daemon mode's interactive workload
+      int one = 1;
+      setsockopt(fd, SOL_TCP, TCP_NODELAY, reinterpret_cast<char*>(&one), sizeof(one));
+
+      auto conn = std::make_shared<connection>(fd);
+      connections[fd] = conn;
+      std::lock_guard<std::mutex> lock(conn->lock);
+      update_events_locked(conn);
+    }
+  }
+
+  void close_retired()
+  {
+    std::vector<std::shared_ptr<connection>> to_close;
+    {
+      std::lock_guard<std::mutex> lock(retired_lock);
+      to_close.swap(retired);
+    }
+    for (auto& conn : to_close)
+    {
+      connections.erase(conn->fd);
+      close(conn->fd);
+    }
+  }
+
+  void parse_request(vw& model, request& r, v_array<example*>& examples, v_array<example*>& line_examples)
+  {
+    // Lines are terminated in place so that the JSON reader, which expects a C string, can parse them.
+    char* line = &r.text[0];
+    char* const end = line + r.text.size();
+    while (line < end)
+    {
+      char* line_end = std::find(line, end, '\n');
+      *line_end = '\0';
+
+      const size_t first = examples.size();
+      if (json)
+      {
+        line_examples.clear();
+        line_examples.push_back(&VW::get_unused_example(&model));
+        model.example_parser->text_reader(&model, line, line_end - line, line_examples);
+        for (example* ex : line_examples) { examples.push_back(ex); }
+        // The text reader leaves out the empty example that ends a multi_ex.
+        if (multiline && line_examples.size() > 1)
+        {
+          example& newline = VW::get_unused_example(&model);
+          substring_to_example(&model, &newline, VW::string_view());
+          examples.push_back(&newline);
+        }
+      }
+      else
+      {
+        size_t length = line_end - line;
+        if (length > 0 && line[length - 1] == '\r') { length--; }
+        examples.push_back(&VW::get_unused_example(&model));
+        substring_to_example(&model, examples.back(), VW::string_view(line, length));
+      }
+
+      for (size_t i = first; i < examples.size(); i++) { VW::setup_example(model, examples[i]); }
+      model.example_parser->end_parsed_examples += examples.size() - first;
+      line = line_end + 1;
+    }
+  }
+
+  void serve(worker& w)
+  {
+    vw& model = *w.model;
+    v_array<example*> examples = v_init<example*>();
+    v_array<example*> line_examples = v_init<example*>();
+    while (true)
+    {
+      request r;
+      {
+        std::unique_lock<std::mutex> lock(queue_lock);
+        queue_cv.wait(lock, [&] { return !queue.empty() || queue_done; });
+        if (queue.empty()) { break; }
+        r = std::move(queue.front());
+        queue.pop_front();
+      }
+
+      examples.clear();
+      try
+      {
+        parse_request(model, r, examples, line_examples);
+        VW::LEARNER::process_parsed_examples(model, examples);
+      }
+      catch (const std::exception& e)
+      {
+        logger::log_error("daemon request failed, closing the connection: {}", e.what());
+        // The examples the learner did not finish go back to the pool.
+        VW_WARNING_STATE_PUSH
+        VW_WARNING_DISABLE_DEPRECATED_USAGE
+        for (example* ex : examples)
+        {
+          if (ex->in_use) { VW::finish_example(model, *ex); }
+        }
+        VW_WARNING_STATE_POP
+        std::lock_guard<std::mutex> lock(r.conn->lock);
+        r.conn->broken = true;
+        r.conn->read_closed = true;
+      }
+
+      std::string response(w.predictions->begin(), w.predictions->end());
+      w.predictions->clear();
+      complete(r.conn, r.id, std::move(response));
+    }
+    examples.delete_v();
+    line_examples.delete_v();
+  }
+
+  void start_workers()
+  {
+    workers.resize(num_workers);
+    for (size_t i = 0; i < num_workers; i++)
+    {
+      worker& w = workers[i];
+      if (i == 0)
+      {
+        w.model = &all;
+        w.owns_model = false;
+      }
+      else
+      {
+        // Shares the weights of the daemon's model. The learners update the shared_data without locking, so like a
+        // forked child each worker gets its own copy of it.
+        w.model = VW::seed_vw_model(&all, "--no_daemon --quiet", nullptr, nullptr);
+        w.owns_model = true;
+        w.sd.reset(new shared_data(*all.sd));
+        w.model->sd = w.sd.get();
+        w.model->example_parser->_shared_data = w.sd.get();
+        w.model->final_regressor_name.clear();
+        w.model->text_regressor_name.clear();
+        w.model->inv_hash_regressor_name.clear();
+        w.model->per_feature_regularizer_output.clear();
+        w.model->per_feature_regularizer_text.clear();
+      }
+      w.predictions = std::make_shared<std::vector<char>>();
+      w.model->final_prediction_sink.clear();
+      w.model->final_prediction_sink.push_back(VW::io::create_vector_writer(w.predictions));
+    }
+    for (auto& w : workers)
+    {
+      worker* target = &w;
+      w.thread = std::thread([this, target] { serve(*target); });
+    }
+  }
+
+  void stop_workers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_lock);
+      queue_done = true;
+    }
+    queue_cv.notify_all();
+    for (auto& w : workers)
+    {
+      if (w.thread.joinable()) { w.thread.join(); }
+    }
+    for (auto& w : workers)
+    {
+      if (w.owns_model) { VW::finish(*w.model); }
+    }
+    workers.clear();
+  }
+
+  void run()
+  {
+    json = all.example_parser->text_reader != VW::read_lines;
+    multiline = all.l->is_multiline;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) { THROWERRNO("epoll_create1"); }
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) { THROWERRNO("eventfd"); }
+
+    fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) != 0) { THROWERRNO("epoll_ctl on the daemon socket"); }
+    ev.data.fd = wakeup_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &ev) != 0) { THROWERRNO("epoll_ctl on the wakeup event"); }
+
+    sigterm_wakeup_fd = wakeup_fd;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_sigterm;
+    sigaction(SIGTERM, &sa, nullptr);
+
+    start_workers();
+    if (!all.logger.quiet)
+    { *(all.trace_message) << "serving daemon connections with " << num_workers << " threads" << std::endl; }
+
+    epoll_event events[max_events];
+    while (!stopping && !got_sigterm)
+    {
+      int count = epoll_wait(epoll_fd, events, max_events, -1);
+      if (count < 0)
+      {
+        if (errno == EINTR) { continue; }
+        THROWERRNO("epoll_wait");
+      }
+
+      for (int i = 0; i < count; i++)
+      {
+        const int fd = events[i].data.fd;
+        if (fd == listen_fd) { accept_connections(); }
+        else if (fd == wakeup_fd)
+        {
+          uint64_t value;
+          ssize_t ignored = read(wakeup_fd, &value, sizeof(value));
+          (void)ignored;
+        }
+        else
+        {
+          auto it = connections.find(fd);
+          if (it == connections.end()) { continue; }
+          std::shared_ptr<connection> conn = it->second;
+          if (events[i].events & EPOLLOUT)
+          {
+            std::lock_guard<std::mutex> lock(conn->lock);
+            flush_locked(*conn);
+            update_events_locked(conn);
+          }
+          if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) { on_readable(conn); }
+        }
+      }
+      close_retired();
+    }
+
+    stop_workers();
+    close_retired();
+    for (auto& entry : connections) { close(entry.first); }
+    connections.clear();
+    sigterm_wakeup_fd = -1;
+  }
+
+  ~impl()
+  {
+    if (epoll_fd >= 0) { close(epoll_fd); }
+    if (wakeup_fd >= 0) { close(wakeup_fd); }
+  }
+};
+
+daemon_server::daemon_server(vw& all, int bound_sock, size_t num_workers)
+    : _impl(new impl(all, bound_sock, num_workers))
+{
+}
+
+daemon_server::~daemon_server() = default;
+
+void daemon_server::run() { _impl->run(); }
+
+void daemon_server::stop()
+{
+  _impl->stopping = true;
+  _impl->wake();
+}
+}  // namespace VW
+
+#else
+
+namespace VW
+{
+struct daemon_server::impl
+{
+};
+
+daemon_server::daemon_server(vw&, int, size_t) { THROW("--daemon_threads is only supported on Linux"); }
+
+daemon_server::~daemon_server() = default;
+
+void daemon_server::run() {}
+
+void daemon_server::stop() {}
+}  // namespace VW
+
+#endif
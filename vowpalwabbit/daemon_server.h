@@ -0,0 +1,45 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+struct vw;
+
+namespace VW
+{
+/**
+ * Serves every daemon connection from one process, enabled with --daemon_threads.
+ *
+ * An event thread accepts connections on the bound socket and reads them with epoll. Complete lines are handed to a
+ * fixed pool of workers as requests, a request being everything that arrived on one connection at once. For multiline
+ * reductions text requests are cut after the last empty line so that a multi_ex never spans two requests. Each worker
+ * has its own vw instance seeded from the daemon's model, so the weights are shared like with the forked children of
+ * --num_children, parses the request with the text or JSON reader and runs it through the learner. Predictions are
+ * sent back on the connection in the order of its requests, whatever order the workers finish them in. Requests of one
+ * connection may be learned from concurrently and so out of order.
+ *
+ * Cache formatted input is not supported. Only available on Linux.
+ */
+class daemon_server
+{
+public:
+  daemon_server(vw& all, int bound_sock, size_t num_workers);
+  ~daemon_server();
+
+  daemon_server(const daemon_server&) = delete;
+  daemon_server& operator=(const daemon_server&) = delete;
+
+  // Serves connections until SIGTERM is received or stop() is called, then waits for the requests in flight.
+  void run();
+  // Can be called from any thread.
+  void stop();
+
+private:
+  struct impl;
+  std::unique_ptr<impl> _impl;
+};
+}  // namespace VW
@@ -27,6 +27,14 @@ void features::clear()
   space_names.clear();
 }
 
+void features::clear_noshrink()
+{
+  sum_feat_sq = 0.f;
+  values.clear_noshrink();
+  indicies.clear_noshrink();
+  space_names.clear();
+}
+
 void features::truncate_to(const features_value_iterator& pos)
 {
   auto i = pos._begin - values.begin();
@@ -51,6 +59,13 @@ void features::push_back(feature_value v, feature_index i)
   sum_feat_sq += v * v;
 }
 
+void features::push_back(const feature_value* v, const feature_index* i, size_t n)
+{
+  values.insert(values.end(), v, v + n);
+  indicies.insert(indicies.end(), i, i + n);
+  for (size_t j = 0; j < n; j++) { sum_feat_sq += v[j] * v[j]; }
+}
+
 bool features::sort(uint64_t parse_mask)
 {
   if (indicies.empty()) { return false; }
@@ -250,9 +250,13 @@ struct features
   inline iterator end() { return {values.end(), indicies.end()}; }
 
   void clear();
+  /// Same as clear but keeps the allocated storage so that it can be refilled without allocating.
+  void clear_noshrink();
   void truncate_to(const features_value_iterator& pos);
   void truncate_to(size_t i);
   void push_back(feature_value v, feature_index i);
+  /// Appends n features at once, same as calling push_back for each.
+  void push_back(const feature_value* v, const feature_index* i, size_t n);
   bool sort(uint64_t parse_mask);
   void deep_copy_from(const features& src);
 };
@@ -60,6 +60,7 @@ struct gd
   bool normalized_input;
   bool adax;
   vw* all;  // parallel, features, parameters
+  std::vector<float> multipredict_scores;  // scratch for the SIMD multipredict
 };
 
 void sync_weights(vw& all);
@@ -137,6 +138,20 @@ float average_update(float total_weight, float normalized_sum_norm_x, float neg_
   return 1.f;
 }
 
+float simd_inline_predict(vw& all, example& ec, float initial)
+{
+  dense_parameters& weights = all.weights.dense_weights;
+  float prediction = initial;
+  for (example_predict::iterator i = ec.begin(); i != ec.end(); ++i)
+  {
+    if (all.ignore_some_linear && all.ignore_linear[i.index()]) { continue; }
+    prediction += simd::dense_dot(weights.first(), weights.mask(), *i, ec.ft_offset);
+  }
+  generate_interactions<float, const float&, vec_add, dense_parameters>(
+      *ec.interactions, all.permutations, ec, prediction, weights);
+  return prediction;
+}
+
 template <bool sqrt_rate, bool feature_mask_off, size_t adaptive, size_t normalized, size_t spare>
 void train(gd& g, example& ec, float update)
 {
@@ -363,6 +378,26 @@ inline void vec_add_print(float& p, const float fx, float& fw)
   std::cerr << " + " << fw << "*" << fx;
 }
 
+// Score of the shared features that shared_feature_merger left out of an action. It is computed for the first action
+// predicted at an offset and reused for the others.
+template <bool l1>
+float shared_context_predict(vw& all, example& ec)
+{
+  auto* context = ec._reduction_features.template get<VW::shared_feature_merger::reduction_features>().context;
+  if (context == nullptr) { return 0.f; }
+
+  for (const auto& score : context->scores)
+  {
+    if (score.first == ec.ft_offset) { return score.second; }
+  }
+
+  example& shared = *context->shared;
+  shared.ft_offset = ec.ft_offset;
+  float score = l1 ? trunc_predict(all, shared, all.sd->gravity) : inline_predict(all, shared);
+  context->scores.emplace_back(ec.ft_offset, score);
+  return score;
+}
+
 template <bool l1, bool audit>
 void predict(gd& g, base_learner&, example& ec)
 {
@@ -373,6 +408,7 @@ void predict(gd& g, base_learner&, example& ec)
     ec.partial_prediction = trunc_predict(all, ec, all.sd->gravity);
   else
     ec.partial_prediction = inline_predict(all, ec);
+  ec.partial_prediction += shared_context_predict<l1>(all, ec);
 
   ec.partial_prediction *= (float)all.sd->contraction;
   ec.pred.scalar = finalize_prediction(all.sd, all.logger, ec.partial_prediction);
@@ -390,16 +426,36 @@ inline void vec_add_trunc_multipredict(multipredict_info<T>& mp, const float fx,
     mp.pred[c].scalar += fx * trunc_weight(mp.weights[index], mp.gravity);
 }
 
+// The scores of a multipredict over dense weights, kept apart from the polypredictions so the classes of a feature are
+// contiguous floats that simd::dense_multi_add can update 8 at a time.
+struct simd_multipredict_info
+{
+  const float* weights;
+  uint64_t mask;
+  uint64_t step;
+  size_t count;
+  float* scores;
+};
+
+inline void vec_add_simd_multipredict(simd_multipredict_info& mp, const float fx, uint64_t fi)
+{
+  if ((-1e-10 < fx) && (fx < 1e-10)) return;
+  fi &= mp.mask;
+  if (fi + (mp.count - 1) * mp.step <= mp.mask)
+  {
+    simd::dense_multi_add(mp.weights, fi, mp.step, mp.count, fx, mp.scores);
+    return;
+  }
+  for (size_t c = 0; c < mp.count; ++c, fi += mp.step) mp.scores[c] += fx * mp.weights[fi & mp.mask];
+}
+
 template <bool l1, bool audit>
 void multipredict(
     gd& g, base_learner&, example& ec, size_t count, size_t step, polyprediction* pred, bool finalize_predictions)
 {
   vw& all = *g.all;
-  for (size_t c = 0; c < count; c++)
-  {
-    const auto& simple_red_features = ec._reduction_features.template get<simple_label_reduction_features>();
-    pred[c].scalar = simple_red_features.initial;
-  }
+  const auto& simple_red_features = ec._reduction_features.template get<simple_label_reduction_features>();
+  for (size_t c = 0; c < count; c++) { pred[c].scalar = simple_red_features.initial; }
 
   if (g.all->weights.sparse)
   {
@@ -410,6 +466,14 @@ void multipredict(
     else
       foreach_feature<multipredict_info<sparse_parameters>, uint64_t, vec_add_multipredict>(all, ec, mp);
   }
+  else if (!l1 && count >= simd::block_size && simd::available())
+  {
+    dense_parameters& weights = all.weights.dense_weights;
+    g.multipredict_scores.assign(count, simple_red_features.initial);
+    simd_multipredict_info mp = {weights.first(), weights.mask(), step, count, g.multipredict_scores.data()};
+    foreach_feature<simd_multipredict_info, uint64_t, vec_add_simd_multipredict>(all, ec, mp);
+    for (size_t c = 0; c < count; c++) pred[c].scalar = g.multipredict_scores[c];
+  }
   else
   {
     multipredict_info<dense_parameters> mp = {count, step, pred, g.all->weights.dense_weights, (float)all.sd->gravity};
@@ -1152,7 +1216,10 @@ base_learner* setup(options_i& options, vw& all)
       .add(make_option("l2_state", all.sd->contraction)
                .keep(all.save_resume)
                .default_value(1.)
-               .help("use per feature normalized updates"));
+               .help("use per feature normalized updates"))
+      .add(make_option("simd_predict", all.simd_predict)
+               .help("sum the linear terms of dense predictions in 8 lanes with AVX2 when the CPU has it. Faster, but "
+                     "predictions and models then differ in the last bits between CPUs"));
   options.add_and_parse(new_options);
 
   g->all = &all;
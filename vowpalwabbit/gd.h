@@ -9,6 +9,7 @@
 #include "interactions.h"
 #include "array_parameters.h"
 #include "gd_predict.h"
+#include "gd_simd.h"
 #include "vw_math.h"
 
 namespace GD
@@ -86,14 +87,21 @@ inline void foreach_feature(vw& all, example& ec, R& dat)
   foreach_feature<R, const float&, T>(all, ec, dat);
 }
 
+// Same as inline_predict<dense_parameters> with the linear terms summed by GD::simd::dense_dot, used with
+// --simd_predict. The sum is not rounded like the scalar loop, so it is opt in.
+float simd_inline_predict(vw& all, example& ec, float initial);
+
 inline float inline_predict(vw& all, example& ec)
 {
   const auto& simple_red_features = ec._reduction_features.template get<simple_label_reduction_features>();
-  return all.weights.sparse
-      ? inline_predict<sparse_parameters>(all.weights.sparse_weights, all.ignore_some_linear, all.ignore_linear,
-            *ec.interactions, all.permutations, ec, simple_red_features.initial)
-      : inline_predict<dense_parameters>(all.weights.dense_weights, all.ignore_some_linear, all.ignore_linear,
-            *ec.interactions, all.permutations, ec, simple_red_features.initial);
+  if (all.weights.sparse)
+  {
+    return inline_predict<sparse_parameters>(all.weights.sparse_weights, all.ignore_some_linear, all.ignore_linear,
+        *ec.interactions, all.permutations, ec, simple_red_features.initial);
+  }
+  if (all.simd_predict && simd::available()) { return simd_inline_predict(all, ec, simple_red_features.initial); }
+  return inline_predict<dense_parameters>(all.weights.dense_weights, all.ignore_some_linear, all.ignore_linear,
+      *ec.interactions, all.permutations, ec, simple_red_features.initial);
 }
 
 inline float trunc_weight(const float w, const float gravity)
@@ -0,0 +1,169 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "gd_simd.h"
+
+#if !defined(VW_NO_INLINE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#  define VW_GD_AVX2
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define VW_TARGET_AVX2
+#    define VW_TARGET_AVX2_NO_FMA
+#  else
+#    define VW_TARGET_AVX2 __attribute__((target("avx2,fma")))
+// Without FMA available the compiler cannot contract a multiply and an add into one.
+#    define VW_TARGET_AVX2_NO_FMA __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace GD
+{
+namespace simd
+{
+namespace
+{
+float dense_dot_scalar(const float* weights, uint64_t mask, const feature_value* values, const feature_index* indices,
+    size_t count, uint64_t offset)
+{
+  float sum = 0.f;
+  for (size_t i = 0; i < count; i++) { sum += values[i] * weights[(indices[i] + offset) & mask]; }
+  return sum;
+}
+
+void multi_add_scalar(const float* weights, uint64_t step, size_t count, float x, float* scores)
+{
+  for (size_t c = 0; c < count; c++, weights += step) { scores[c] += x * *weights; }
+}
+
+#if defined(VW_GD_AVX2)
+bool cpu_has_avx2()
+{
+#  if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) { return false; }
+  __cpuid(info, 1);
+  const bool fma = (info[2] & (1 << 12)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (!fma || !osxsave || (_xgetbv(0) & 6) != 6) { return false; }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#  else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0;
+#  endif
+}
+
+// Weight indices of the 8 features at indices, in two registers of 4.
+struct block_indices
+{
+  __m256i lo;
+  __m256i hi;
+};
+
+VW_TARGET_AVX2 inline block_indices load_indices(const feature_index* indices, __m256i offset, __m256i mask)
+{
+  const __m256i* p = reinterpret_cast<const __m256i*>(indices);
+  return {_mm256_and_si256(_mm256_add_epi64(_mm256_loadu_si256(p), offset), mask),
+      _mm256_and_si256(_mm256_add_epi64(_mm256_loadu_si256(p + 1), offset), mask)};
+}
+
+VW_TARGET_AVX2 inline __m256 gather(const float* base, const block_indices& idx)
+{
+  const __m128 lo = _mm256_i64gather_ps(base, idx.lo, 4);
+  const __m128 hi = _mm256_i64gather_ps(base, idx.hi, 4);
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+VW_TARGET_AVX2 inline float horizontal_sum(__m256 v)
+{
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+VW_TARGET_AVX2 float dense_dot_avx2(const float* weights, uint64_t mask, const features& fs, uint64_t offset)
+{
+  const feature_value* values = fs.values.begin();
+  const feature_index* indices = fs.indicies.begin();
+  const size_t count = fs.size();
+  const __m256i voffset = _mm256_set1_epi64x(static_cast<long long>(offset));
+  const __m256i vmask = _mm256_set1_epi64x(static_cast<long long>(mask));
+
+  // Two accumulators so consecutive blocks do not wait on each other's FMA.
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 2 * block_size <= count; i += 2 * block_size)
+  {
+    const block_indices idx0 = load_indices(indices + i, voffset, vmask);
+    const block_indices idx1 = load_indices(indices + i + block_size, voffset, vmask);
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), gather(weights, idx0), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i + block_size), gather(weights, idx1), acc1);
+  }
+  if (i + block_size <= count)
+  {
+    const block_indices idx = load_indices(indices + i, voffset, vmask);
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(values + i), gather(weights, idx), acc0);
+    i += block_size;
+  }
+  const float sum = horizontal_sum(_mm256_add_ps(acc0, acc1));
+  // Compilers only add this when optimizing, without it the SSE code after the call runs with dirty upper halves.
+  _mm256_zeroupper();
+  return sum + dense_dot_scalar(weights, mask, values + i, indices + i, count - i, offset);
+}
+
+VW_TARGET_AVX2_NO_FMA void dense_multi_add_avx2(const float* weights, uint64_t step, size_t count, float x, float* scores)
+{
+  const __m256i lanes =
+      _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(step)));
+  const __m256 vx = _mm256_set1_ps(x);
+  size_t c = 0;
+  for (; c + block_size <= count; c += block_size, weights += block_size * step)
+  {
+    // Multiply and add rather than FMA, to round like the scalar loop.
+    const __m256 products = _mm256_mul_ps(vx, _mm256_i32gather_ps(weights, lanes, 4));
+    _mm256_storeu_ps(scores + c, _mm256_add_ps(_mm256_loadu_ps(scores + c), products));
+  }
+  _mm256_zeroupper();
+  multi_add_scalar(weights, step, count - c, x, scores + c);
+}
+#endif
+}  // namespace
+
+bool available()
+{
+#if defined(VW_GD_AVX2)
+  static const bool has_avx2 = cpu_has_avx2();
+  return has_avx2;
+#else
+  return false;
+#endif
+}
+
+float dense_dot(const float* weights, uint64_t mask, const features& fs, uint64_t offset)
+{
+#if defined(VW_GD_AVX2)
+  // Namespaces shorter than a block only pay for entering the kernel.
+  if (fs.size() >= block_size && available()) { return dense_dot_avx2(weights, mask, fs, offset); }
+#endif
+  return dense_dot_scalar(weights, mask, fs.values.begin(), fs.indicies.begin(), fs.size(), offset);
+}
+
+void dense_multi_add(const float* weights, uint64_t index, uint64_t step, size_t count, float x, float* scores)
+{
+#if defined(VW_GD_AVX2)
+  // The gather takes 32 bit offsets.
+  if (count >= block_size && step <= INT32_MAX / block_size && available())
+  {
+    dense_multi_add_avx2(weights + index, step, count, x, scores);
+    return;
+  }
+#endif
+  multi_add_scalar(weights + index, step, count, x, scores);
+}
+}  // namespace simd
+}  // namespace GD
@@ -0,0 +1,38 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "feature_group.h"
+
+/*
+ * Dot product of the linear terms of GD over dense weights. With AVX2 the weights of 8 features are gathered at once
+ * and the products are summed in 8 lanes, so predictions can differ from the scalar loop of gd_predict.h in the last
+ * bits. GD therefore only uses it with --simd_predict. The kernels are compiled for AVX2 regardless of the target
+ * flags and only used when the CPU supports it at runtime.
+ *
+ * For multipredict the weights of 8 classes of one feature are gathered at once instead. Each class still adds its
+ * features one at a time in the same order, so those scores match the scalar loop exactly.
+ */
+namespace GD
+{
+namespace simd
+{
+// Features handled per step of the kernel, shorter namespaces go through the scalar loop.
+constexpr size_t block_size = 8;
+
+// True if the AVX2 kernel can be used on this machine.
+bool available();
+
+// Sum of x * weights[(index + offset) & mask] over the features of fs.
+float dense_dot(const float* weights, uint64_t mask, const features& fs, uint64_t offset);
+
+// Adds x * weights[index + c * step] to scores[c] for every c in [0, count). The caller makes sure the last index is
+// within the weights, nothing is masked.
+void dense_multi_add(const float* weights, uint64_t index, uint64_t step, size_t count, float x, float* scores);
+}  // namespace simd
+}  // namespace GD
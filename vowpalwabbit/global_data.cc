@@ -321,6 +321,9 @@ vw::vw() : options(nullptr, nullptr)
   initial_constant = 0.0;
 
   all_reduce = nullptr;
+  learner_threads = 1;
+  all_reduce_sparse = false;
+  all_reduce_precision = AllReducePrecision::Float32;
 
   for (size_t i = 0; i < NUM_NAMESPACES; i++)
   {
@@ -334,6 +337,7 @@ vw::vw() : options(nullptr, nullptr)
 
   add_constant = true;
   audit = false;
+  simd_predict = false;
 
   pass_length = std::numeric_limits<size_t>::max();
   passes_complete = 0;
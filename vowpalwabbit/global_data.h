@@ -74,6 +74,22 @@ enum AllReduceType
   Thread
 };
 
+// Encoding of the weights accumulate and accumulate_avg send to the other nodes.
+enum class AllReducePrecision
+{
+  Float32,
+  Float16,
+  BFloat16
+};
+
+// Rounding errors kept by accumulate between syncs, only for the weight rows that have any. rows is sorted and values
+// holds the errors of each of them back to back.
+struct all_reduce_residual_rows
+{
+  std::vector<uint64_t> rows;
+  std::vector<float> values;
+};
+
 class AllReduce;
 
 struct vw_logger
@@ -134,6 +150,11 @@ public:
 
   AllReduceType all_reduce_type;
   AllReduce* all_reduce;
+  size_t learner_threads;  // number of threads learning from the parsed examples on the shared weights
+  bool all_reduce_sparse;  // accumulate only sends the weights that are not zero on some node
+  AllReducePrecision all_reduce_precision;
+  // Rounding error of the weights sent at lower precision, added to the next accumulate. Keyed by caller and slot.
+  std::map<std::pair<size_t, size_t>, all_reduce_residual_rows> all_reduce_residuals;
 
   bool chain_hash_json = false;
 
@@ -223,6 +244,7 @@ public:
   std::array<bool, NUM_NAMESPACES> ignore;  // a set of namespaces to ignore
   bool ignore_some_linear;
   std::array<bool, NUM_NAMESPACES> ignore_linear;  // a set of namespaces to ignore for linear
+  bool simd_predict;  // sum the linear terms of dense predictions with the AVX2 kernel of gd_simd.h
 
   bool redefine_some;                                  // --redefine param was used
   std::array<unsigned char, NUM_NAMESPACES> redefine;  // keeps new chars for namespaces
@@ -347,6 +369,7 @@ VW_DEPRECATED("Use binary_print_result_by_ref instead")
 void binary_print_result(VW::io::writer* f, float res, float weight, v_array<char> tag);
 void binary_print_result_by_ref(VW::io::writer* f, float res, float weight, const v_array<char>& tag);
 
+void set_mm(shared_data* sd, float label);
 void noop_mm(shared_data*, float label);
 void get_prediction(VW::io::reader* f, float& res, float& weight);
 void compile_gram(
@@ -355,4 +378,4 @@ void compile_limits(std::vector<std::string> limits, std::array<uint32_t, NUM_NA
 
 VW_DEPRECATED("Use print_tag_by_ref instead")
 int print_tag(std::stringstream& ss, v_array<char> tag);
-int print_tag_by_ref(std::stringstream& ss, const v_array<char>& tag);
\ No newline at end of file
+int print_tag_by_ref(std::stringstream& ss, const v_array<char>& tag);
\ No newline at end of file
@@ -0,0 +1,34 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "hash_cache.h"
+
+namespace VW
+{
+constexpr size_t hash_cache::min_token_length;
+constexpr size_t hash_cache::max_token_length;
+
+hash_cache::hash_cache(size_t size, hash_cache_stats& stats) : _stats(stats)
+{
+  size_t slots = 1;
+  while (slots < size) { slots <<= 1; }
+  entry empty;
+  empty.seed = 0;
+  empty.hash = 0;
+  // No token is this long, so empty slots never match.
+  empty.length = max_token_length + 1;
+  _entries.assign(slots, empty);
+  _mask = slots - 1;
+}
+
+hash_cache::~hash_cache() { flush_stats(); }
+
+void hash_cache::flush_stats()
+{
+  _stats.lookups += _lookups;
+  _stats.hits += _hits;
+  _lookups = 0;
+  _hits = 0;
+}
+}  // namespace VW
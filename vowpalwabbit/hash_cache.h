@@ -0,0 +1,105 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "future_compat.h"
+#include "hashstring.h"
+#include "vw_string_view.h"
+
+namespace VW
+{
+/// Lookups and hits of all the hash_caches of a parser, gathered with hash_cache::flush_stats.
+struct hash_cache_stats
+{
+  std::atomic<uint64_t> lookups{0};
+  std::atomic<uint64_t> hits{0};
+};
+
+/**
+ * Remembers the hashes of recently parsed tokens so that a vocabulary seen over and over is not hashed again. An
+ * entry is keyed by the seed, which for features is the namespace hash, and the token itself.
+ *
+ * The cache is direct mapped: each token can only live in one slot and replaces whatever token was there. Tokens
+ * shorter than min_token_length or longer than max_token_length are always hashed. A cache is not shared between
+ * threads, every parser owns one and only its counts go to the shared hash_cache_stats.
+ */
+class hash_cache
+{
+public:
+  // Shorter tokens hash faster than they are looked up, longer ones do not fit an entry.
+  static constexpr size_t min_token_length = 8;
+  static constexpr size_t max_token_length = 46;
+
+  /// size is rounded up to a power of two.
+  hash_cache(size_t size, hash_cache_stats& stats);
+  ~hash_cache();
+
+  hash_cache(const hash_cache&) = delete;
+  hash_cache& operator=(const hash_cache&) = delete;
+
+  /// Returns hasher(token, seed). The hasher is not part of the key, so a cache must always be used with the same one.
+  inline FORCE_INLINE uint64_t hash(hash_func_t hasher, VW::string_view token, uint64_t seed)
+  {
+    const size_t length = token.length();
+    if (length < min_token_length || length > max_token_length) { return hasher(token.begin(), length, seed); }
+
+    _lookups++;
+    entry& e = _entries[slot(token.begin(), length, seed)];
+    if (e.length == length && e.seed == seed && std::memcmp(e.token, token.begin(), length) == 0)
+    {
+      _hits++;
+      return e.hash;
+    }
+
+    e.seed = seed;
+    e.hash = hasher(token.begin(), length, seed);
+    e.length = static_cast<unsigned char>(length);
+    std::memcpy(e.token, token.begin(), length);
+    return e.hash;
+  }
+
+  /// Adds the lookups and hits since the last call to the shared stats.
+  void flush_stats();
+
+private:
+  // One cache line per entry.
+  struct entry
+  {
+    uint64_t seed;
+    uint64_t hash;
+    unsigned char length;
+    char token[max_token_length + 1];
+  };
+
+  // Mixes the seed with the length and the first, middle and last 8 bytes of the token. Much cheaper than hashing the
+  // whole token and enough to spread a vocabulary over the slots.
+  inline FORCE_INLINE size_t slot(const char* token, size_t length, uint64_t seed) const
+  {
+    uint64_t head;
+    uint64_t middle;
+    uint64_t tail;
+    std::memcpy(&head, token, sizeof(head));
+    std::memcpy(&middle, token + (length - sizeof(middle)) / 2, sizeof(middle));
+    std::memcpy(&tail, token + length - sizeof(tail), sizeof(tail));
+
+    uint64_t key = (seed ^ head) * 0x9E3779B97F4A7C15ULL + length;
+    key = (key ^ (key >> 29) ^ middle) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 32) ^ tail) * 0x94D049BB133111EBULL;
+    return static_cast<size_t>((key ^ (key >> 31)) & _mask);
+  }
+
+  std::vector<entry> _entries;
+  uint64_t _mask;
+  uint64_t _lookups = 0;
+  uint64_t _hits = 0;
+  hash_cache_stats& _stats;
+};
+}  // namespace VW
@@ -0,0 +1,621 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "io_adapter.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+#ifdef BUILD_ZSTD
+#  include <zstd.h>
+#endif
+
+using namespace VW::io;
+
+namespace
+{
+// bgzf, as written by bgzip, is gzip cut into members of at most 64KiB which carry their compressed size in an extra
+// header field. The members can therefore be found without decompressing anything and inflated independently.
+constexpr size_t bgzf_header_size = 18;
+constexpr size_t bgzf_footer_size = 8;
+constexpr size_t bgzf_max_input = 0xff00;
+// The empty member bgzip ends its files with.
+constexpr unsigned char bgzf_eof[28] = {0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 0x06, 0, 0x42, 0x43, 0x02, 0, 0x1b,
+    0, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// Unit in which the compressed input is read.
+constexpr size_t read_size = 1 << 20;
+// Consecutive blocks are handed to the workers together until they reach this compressed size.
+constexpr size_t batch_size = 1 << 20;
+// Output size of the steps of input that has to be decompressed sequentially.
+constexpr size_t stream_step_size = 1 << 20;
+// zstd frames which decompress to more than this, or do not say, are decompressed sequentially.
+constexpr unsigned long long max_zstd_frame_size = 64 << 20;
+
+inline bool is_gzip(const unsigned char* p, size_t available)
+{
+  return available >= 2 && p[0] == 0x1f && p[1] == 0x8b;
+}
+
+inline bool is_zstd(const unsigned char* p, size_t available)
+{
+  // Either a regular frame or a skippable frame, which seekable zstd files end with.
+  return available >= 4 &&
+      ((p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd) ||
+          ((p[0] & 0xf0) == 0x50 && p[1] == 0x2a && p[2] == 0x4d && p[3] == 0x18));
+}
+
+inline uint32_t read_le32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24); }
+
+inline void write_le16(unsigned char* p, uint32_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+}
+
+inline void write_le32(unsigned char* p, uint32_t v)
+{
+  write_le16(p, v & 0xffff);
+  write_le16(p + 2, v >> 16);
+}
+
+// Size of the extra field if the available bytes start with a gzip header that has one, otherwise 0.
+size_t gzip_extra_size(const unsigned char* p, size_t available)
+{
+  if (available < 12 || !is_gzip(p, available) || p[2] != 8 || (p[3] & 4) == 0) { return 0; }
+  return p[10] | (p[11] << 8);
+}
+
+// Total size of the bgzf member at p, 0 if p does not start with one. Needs the complete gzip header.
+size_t bgzf_member_size(const unsigned char* p, size_t available)
+{
+  const size_t xlen = gzip_extra_size(p, available);
+  if (xlen == 0 || available < 12 + xlen) { return 0; }
+  for (size_t i = 12; i + 4 <= 12 + xlen;)
+  {
+    const size_t slen = p[i + 2] | (p[i + 3] << 8);
+    if (p[i] == 'B' && p[i + 1] == 'C' && slen == 2 && i + 6 <= 12 + xlen)
+    {
+      const size_t size = (p[i + 4] | (p[i + 5] << 8)) + 1;
+      return size >= 12 + xlen + bgzf_footer_size ? size : 0;
+    }
+    i += 4 + slen;
+  }
+  return 0;
+}
+
+// Ends an inflate stream however the scope is left.
+struct inflate_guard
+{
+  z_stream* zs;
+  ~inflate_guard() { inflateEnd(zs); }
+};
+
+struct block
+{
+  std::vector<unsigned char> compressed;
+  std::vector<char> output;
+  bool zstd = false;
+  size_t consumed = 0;
+  bool done = false;
+  std::exception_ptr exc;
+};
+
+void inflate_bgzf_members(block& b)
+{
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (inflateInit2(&zs, 15 + 16) != Z_OK) { THROW("failed to initialize zlib"); }
+  inflate_guard guard{&zs};
+
+  for (size_t pos = 0; pos < b.compressed.size();)
+  {
+    const unsigned char* member = b.compressed.data() + pos;
+    const size_t size = bgzf_member_size(member, b.compressed.size() - pos);
+    const uint32_t uncompressed_size = read_le32(member + size - 4);
+    pos += size;
+    // Such as the end of file marker.
+    if (uncompressed_size == 0) { continue; }
+
+    const size_t out = b.output.size();
+    b.output.resize(out + uncompressed_size);
+    inflateReset(&zs);
+    zs.next_in = const_cast<unsigned char*>(member);
+    zs.avail_in = static_cast<uInt>(size);
+    zs.next_out = reinterpret_cast<Bytef*>(b.output.data() + out);
+    zs.avail_out = static_cast<uInt>(b.output.size() - out);
+    if (inflate(&zs, Z_FINISH) != Z_STREAM_END || zs.avail_out != 0)
+    { THROW("bgzf block is corrupt" << (zs.msg != nullptr ? ": " : "") << (zs.msg != nullptr ? zs.msg : "")); }
+  }
+}
+
+#ifdef BUILD_ZSTD
+void decompress_zstd_frames(block& b)
+{
+  for (size_t pos = 0; pos < b.compressed.size();)
+  {
+    const unsigned char* frame = b.compressed.data() + pos;
+    const size_t available = b.compressed.size() - pos;
+    const size_t size = ZSTD_findFrameCompressedSize(frame, available);
+    const auto content_size = static_cast<size_t>(ZSTD_getFrameContentSize(frame, available));
+    pos += size;
+    // Such as skippable frames.
+    if (content_size == 0) { continue; }
+
+    const size_t out = b.output.size();
+    b.output.resize(out + content_size);
+    const size_t result = ZSTD_decompress(b.output.data() + out, content_size, frame, size);
+    if (ZSTD_isError(result) || result != content_size)
+    { THROW("zstd frame is corrupt: " << (ZSTD_isError(result) ? ZSTD_getErrorName(result) : "wrong size")); }
+  }
+}
+#endif
+
+class decompressing_reader : public reader
+{
+public:
+  decompressing_reader(std::unique_ptr<reader> input, size_t num_threads)
+      : reader(input->is_resettable()), _input(std::move(input)), _num_threads(std::max<size_t>(num_threads, 1))
+  {
+    start();
+  }
+
+  ~decompressing_reader() override { stop(); }
+
+  ssize_t read(char* buffer, size_t num_bytes) override
+  {
+    std::unique_lock<std::mutex> lock(_mut);
+    while (true)
+    {
+      _block_done.wait(lock, [this] { return _blocks.empty() ? _input_done : _blocks.front()->done; });
+      if (_blocks.empty()) { return 0; }
+
+      block& b = *_blocks.front();
+      if (b.exc) { std::rethrow_exception(b.exc); }
+      if (b.consumed == b.output.size())
+      {
+        _blocks.pop_front();
+        _room_available.notify_one();
+        continue;
+      }
+
+      // Nothing but this thread touches a block once it is done.
+      lock.unlock();
+      const size_t n = std::min(num_bytes, b.output.size() - b.consumed);
+      std::memcpy(buffer, b.output.data() + b.consumed, n);
+      b.consumed += n;
+      return static_cast<ssize_t>(n);
+    }
+  }
+
+  void reset() override
+  {
+    stop();
+    _input->reset();
+    start();
+  }
+
+private:
+  void start()
+  {
+    _shutdown = false;
+    _input_done = false;
+    _threads.emplace_back(&decompressing_reader::dispatch, this);
+    for (size_t i = 0; i < _num_threads; i++) { _threads.emplace_back(&decompressing_reader::work, this); }
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      _shutdown = true;
+    }
+    _work_available.notify_all();
+    _room_available.notify_all();
+    for (auto& thread : _threads) { thread.join(); }
+    _threads.clear();
+    _blocks.clear();
+    _work.clear();
+    _raw.clear();
+    _raw_pos = 0;
+    _raw_eof = false;
+  }
+
+  // Queues b behind the blocks read before it. Returns false if the reader is shutting down.
+  bool submit(std::unique_ptr<block> b, bool needs_work)
+  {
+    std::unique_lock<std::mutex> lock(_mut);
+    _room_available.wait(lock, [this] { return _shutdown || _blocks.size() < 2 * _num_threads + 2; });
+    if (_shutdown) { return false; }
+    block* queued = b.get();
+    queued->done = !needs_work;
+    _blocks.push_back(std::move(b));
+    if (needs_work)
+    {
+      _work.push_back(queued);
+      _work_available.notify_one();
+    }
+    else
+    {
+      _block_done.notify_all();
+    }
+    return true;
+  }
+
+  void work()
+  {
+    while (true)
+    {
+      block* b;
+      {
+        std::unique_lock<std::mutex> lock(_mut);
+        _work_available.wait(lock, [this] { return _shutdown || !_work.empty(); });
+        if (_shutdown) { return; }
+        b = _work.front();
+        _work.pop_front();
+      }
+
+      try
+      {
+#ifdef BUILD_ZSTD
+        if (b->zstd) { decompress_zstd_frames(*b); }
+        else
+#endif
+        {
+          inflate_bgzf_members(*b);
+        }
+      }
+      catch (...)
+      {
+        b->exc = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(_mut);
+        b->done = true;
+      }
+      _block_done.notify_all();
+    }
+  }
+
+  // Runs on its own thread. Cuts the input into blocks for the workers, or decompresses it itself if it cannot be cut.
+  void dispatch()
+  {
+    try
+    {
+      const size_t available = fill(4);
+      if (is_gzip(raw(), available)) { dispatch_gzip(); }
+      else if (is_zstd(raw(), available))
+      {
+#ifdef BUILD_ZSTD
+        dispatch_zstd();
+#else
+        THROW("zstd compressed input is not supported, VW has to be built with BUILD_ZSTD");
+#endif
+      }
+      else
+      {
+        pass_through();
+      }
+    }
+    catch (...)
+    {
+      auto b = std::unique_ptr<block>(new block());
+      b->exc = std::current_exception();
+      submit(std::move(b), false);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      _input_done = true;
+    }
+    _block_done.notify_all();
+  }
+
+  void dispatch_gzip()
+  {
+    std::unique_ptr<block> b;
+    while (true)
+    {
+      size_t available = fill(12);
+      available = fill(12 + gzip_extra_size(raw(), available));
+      const size_t size = bgzf_member_size(raw(), available);
+      if (size == 0 || (b && b->compressed.size() + size > batch_size))
+      {
+        if (b && !submit(std::move(b), true)) { return; }
+        if (size == 0)
+        {
+          // Plain gzip has to be inflated in order, this also covers the end of the input.
+          if (available > 0) { stream_gzip(); }
+          return;
+        }
+      }
+      if (fill(size) < size) { THROW("bgzf input is truncated"); }
+
+      if (!b) { b = std::unique_ptr<block>(new block()); }
+      b->compressed.insert(b->compressed.end(), raw(), raw() + size);
+      _raw_pos += size;
+    }
+  }
+
+  void stream_gzip()
+  {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    // Also accepts zlib streams, like gzread does.
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) { THROW("failed to initialize zlib"); }
+    inflate_guard guard{&zs};
+
+    bool finished = false;
+    while (!finished)
+    {
+      auto b = std::unique_ptr<block>(new block());
+      b->output.resize(stream_step_size);
+      size_t out = 0;
+      while (out < b->output.size())
+      {
+        const size_t available = std::min<size_t>(fill(1), UINT_MAX);
+        if (available == 0)
+        {
+          // Truncated input ends quietly, as with gzread.
+          finished = true;
+          break;
+        }
+        zs.next_in = const_cast<unsigned char*>(raw());
+        zs.avail_in = static_cast<uInt>(available);
+        zs.next_out = reinterpret_cast<Bytef*>(b->output.data() + out);
+        zs.avail_out = static_cast<uInt>(b->output.size() - out);
+        const int result = inflate(&zs, Z_NO_FLUSH);
+        _raw_pos += available - zs.avail_in;
+        out = b->output.size() - zs.avail_out;
+
+        if (result == Z_STREAM_END)
+        {
+          // Concatenated gzip members form a single stream, anything else after the end is ignored.
+          if (is_gzip(raw(), fill(2))) { inflateReset(&zs); }
+          else
+          {
+            finished = true;
+            break;
+          }
+        }
+        else if (result != Z_OK && result != Z_BUF_ERROR)
+        {
+          THROW("gzip input is corrupt" << (zs.msg != nullptr ? ": " : "") << (zs.msg != nullptr ? zs.msg : ""));
+        }
+      }
+      b->output.resize(out);
+      if (!submit(std::move(b), false)) { return; }
+    }
+  }
+
+#ifdef BUILD_ZSTD
+  void dispatch_zstd()
+  {
+    std::unique_ptr<block> b;
+    while (true)
+    {
+      // 18 bytes hold the largest frame header.
+      size_t available = fill(18);
+      size_t size = 0;
+      if (available > 0)
+      {
+        const unsigned long long content_size = ZSTD_getFrameContentSize(raw(), available);
+        if (content_size <= max_zstd_frame_size)
+        {
+          size = ZSTD_findFrameCompressedSize(raw(), available);
+          while (ZSTD_isError(size) && !_raw_eof)
+          {
+            available = fill(available + read_size);
+            size = ZSTD_findFrameCompressedSize(raw(), available);
+          }
+          if (ZSTD_isError(size)) { THROW("zstd input is truncated"); }
+        }
+      }
+
+      if (size == 0 || (b && b->compressed.size() + size > batch_size))
+      {
+        if (b && !submit(std::move(b), true)) { return; }
+        if (size == 0)
+        {
+          // Frames that do not say how large they are have to be decompressed in order, this also covers the end.
+          if (available > 0) { stream_zstd(); }
+          return;
+        }
+      }
+
+      if (!b)
+      {
+        b = std::unique_ptr<block>(new block());
+        b->zstd = true;
+      }
+      b->compressed.insert(b->compressed.end(), raw(), raw() + size);
+      _raw_pos += size;
+    }
+  }
+
+  void stream_zstd()
+  {
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (stream == nullptr) { THROW("failed to initialize zstd"); }
+    std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream*)> guard(stream, ZSTD_freeDStream);
+    ZSTD_initDStream(stream);
+
+    bool finished = false;
+    while (!finished)
+    {
+      auto b = std::unique_ptr<block>(new block());
+      b->output.resize(stream_step_size);
+      ZSTD_outBuffer out = {b->output.data(), b->output.size(), 0};
+      while (out.pos < out.size)
+      {
+        const size_t available = fill(1);
+        if (available == 0)
+        {
+          finished = true;
+          break;
+        }
+        ZSTD_inBuffer in = {raw(), available, 0};
+        const size_t result = ZSTD_decompressStream(stream, &out, &in);
+        _raw_pos += in.pos;
+        if (ZSTD_isError(result)) { THROW("zstd input is corrupt: " << ZSTD_getErrorName(result)); }
+      }
+      b->output.resize(out.pos);
+      if (!submit(std::move(b), false)) { return; }
+    }
+  }
+#endif
+
+  void pass_through()
+  {
+    while (true)
+    {
+      // Hands on whatever a single read returns, stdin may not deliver more for a while.
+      const size_t available = fill(1);
+      if (available == 0) { return; }
+      auto b = std::unique_ptr<block>(new block());
+      b->output.assign(raw(), raw() + available);
+      _raw_pos += available;
+      if (!submit(std::move(b), false)) { return; }
+    }
+  }
+
+  const unsigned char* raw() const { return _raw.data() + _raw_pos; }
+
+  // Makes at least n unread bytes of the input available unless it ends first. Returns the number available.
+  size_t fill(size_t n)
+  {
+    if (_raw.size() - _raw_pos >= n || _raw_eof) { return _raw.size() - _raw_pos; }
+    _raw.erase(_raw.begin(), _raw.begin() + _raw_pos);
+    _raw_pos = 0;
+    while (_raw.size() < n && !_raw_eof)
+    {
+      const size_t old_size = _raw.size();
+      _raw.resize(old_size + std::max(read_size, n - old_size));
+      const ssize_t num_read = _input->read(reinterpret_cast<char*>(_raw.data() + old_size), _raw.size() - old_size);
+      _raw.resize(old_size + std::max<ssize_t>(num_read, 0));
+      if (num_read <= 0) { _raw_eof = true; }
+    }
+    return _raw.size();
+  }
+
+  std::unique_ptr<reader> _input;
+  size_t _num_threads;
+  std::vector<std::thread> _threads;
+
+  std::mutex _mut;
+  std::condition_variable _block_done;
+  std::condition_variable _work_available;
+  std::condition_variable _room_available;
+  // Blocks in input order, and those of them still waiting for a worker.
+  std::deque<std::unique_ptr<block>> _blocks;
+  std::deque<block*> _work;
+  bool _input_done = false;
+  bool _shutdown = false;
+
+  // Only touched by the dispatch thread.
+  std::vector<unsigned char> _raw;
+  size_t _raw_pos = 0;
+  bool _raw_eof = false;
+};
+
+class bgzf_writer : public writer
+{
+public:
+  explicit bgzf_writer(std::unique_ptr<writer> output) : _output(std::move(output))
+  {
+    std::memset(&_zs, 0, sizeof(_zs));
+    if (deflateInit2(&_zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    { THROW("failed to initialize zlib"); }
+    _pending.reserve(bgzf_max_input);
+  }
+
+  // Errors can only be logged here, flush first to have them thrown.
+  ~bgzf_writer() override
+  {
+    try
+    {
+      write_member();
+      _output->write(reinterpret_cast<const char*>(bgzf_eof), sizeof(bgzf_eof));
+    }
+    catch (const std::exception& e)
+    {
+      VW::io::logger::errlog_error("failed to finish bgzf output: {}", e.what());
+    }
+    deflateEnd(&_zs);
+  }
+
+  ssize_t write(const char* buffer, size_t num_bytes) override
+  {
+    for (size_t written = 0; written < num_bytes;)
+    {
+      const size_t n = std::min(bgzf_max_input - _pending.size(), num_bytes - written);
+      _pending.insert(_pending.end(), buffer + written, buffer + written + n);
+      written += n;
+      if (_pending.size() == bgzf_max_input) { write_member(); }
+    }
+    return static_cast<ssize_t>(num_bytes);
+  }
+
+  void flush() override
+  {
+    write_member();
+    _output->flush();
+  }
+
+private:
+  void write_member()
+  {
+    if (_pending.empty()) { return; }
+
+    deflateReset(&_zs);
+    _member.resize(bgzf_header_size + deflateBound(&_zs, static_cast<uLong>(_pending.size())) + bgzf_footer_size);
+    _zs.next_in = reinterpret_cast<Bytef*>(_pending.data());
+    _zs.avail_in = static_cast<uInt>(_pending.size());
+    _zs.next_out = _member.data() + bgzf_header_size;
+    _zs.avail_out = static_cast<uInt>(_member.size() - bgzf_header_size - bgzf_footer_size);
+    if (deflate(&_zs, Z_FINISH) != Z_STREAM_END) { THROW("failed to compress bgzf block"); }
+
+    const size_t member_size = bgzf_header_size + _zs.total_out + bgzf_footer_size;
+    std::memcpy(_member.data(), bgzf_eof, bgzf_header_size);
+    write_le16(_member.data() + 16, static_cast<uint32_t>(member_size - 1));
+    unsigned char* footer = _member.data() + bgzf_header_size + _zs.total_out;
+    write_le32(footer, crc32(crc32(0, nullptr, 0), reinterpret_cast<Bytef*>(_pending.data()),
+                           static_cast<uInt>(_pending.size())));
+    write_le32(footer + 4, static_cast<uint32_t>(_pending.size()));
+    _output->write(reinterpret_cast<const char*>(_member.data()), member_size);
+    _pending.clear();
+  }
+
+  std::unique_ptr<writer> _output;
+  z_stream _zs;
+  std::vector<char> _pending;
+  std::vector<unsigned char> _member;
+};
+}  // namespace
+
+namespace VW
+{
+namespace io
+{
+std::unique_ptr<reader> create_decompressing_reader(std::unique_ptr<reader> compressed, size_t num_threads)
+{
+  return std::unique_ptr<reader>(new decompressing_reader(std::move(compressed), num_threads));
+}
+
+std::unique_ptr<writer> open_compressed_file_writer(const std::string& file_path)
+{
+  return std::unique_ptr<writer>(new bgzf_writer(open_file_writer(file_path)));
+}
+}  // namespace io
+}  // namespace VW
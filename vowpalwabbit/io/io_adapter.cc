@@ -10,6 +10,7 @@
 #  include <winsock2.h>
 #  include <io.h>
 #else
+#  include <sys/mman.h>
 #  include <sys/socket.h>
 #  include <unistd.h>
 #endif
@@ -138,6 +139,22 @@ private:
   gzFile _gz_stdout;
 };
 
+#ifndef _WIN32
+struct mapped_file_adapter : public reader
+{
+  mapped_file_adapter(char* data, size_t len);
+  ~mapped_file_adapter();
+  ssize_t read(char* buffer, size_t num_bytes) override;
+  void reset() override;
+  bool read_in_place(char*& data, size_t& len) override;
+
+private:
+  char* _data;
+  size_t _len;
+  size_t _offset = 0;
+};
+#endif
+
 struct custom_func_writer : public writer
 {
   custom_func_writer(void* context, write_func_t write_func);
@@ -186,9 +203,27 @@ std::unique_ptr<reader> open_file_reader(const std::string& file_path)
   return std::unique_ptr<reader>(new file_adapter(file_path.c_str(), file_mode::read));
 }
 
-std::unique_ptr<writer> open_compressed_file_writer(const std::string& file_path)
+std::unique_ptr<reader> open_mapped_file_reader(const std::string& file_path)
 {
-  return std::unique_ptr<writer>(new gzip_file_adapter(file_path.c_str(), file_mode::write));
+#ifndef _WIN32
+  int fd = ::open(file_path.c_str(), O_RDONLY | O_LARGEFILE);
+  if (fd >= 0)
+  {
+    char* data = nullptr;
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+    {
+      // A private writable mapping keeps the in place view usable as a regular char buffer. Pages are only copied if
+      // they are written to, which readers do not do.
+      void* mapping = ::mmap(nullptr, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) { data = static_cast<char*>(mapping); }
+    }
+    ::close(fd);
+    if (data != nullptr)
+    { return std::unique_ptr<reader>(new mapped_file_adapter(data, static_cast<size_t>(file_stat.st_size))); }
+  }
+#endif
+  return open_file_reader(file_path);
 }
 
 std::unique_ptr<reader> open_compressed_file_reader(const std::string& file_path)
@@ -349,6 +384,39 @@ file_adapter::~file_adapter()
   }
 }
 
+#ifndef _WIN32
+//
+// mapped_file_adapter
+//
+
+mapped_file_adapter::mapped_file_adapter(char* data, size_t len)
+    : reader(true /*is_resettable*/), _data(data), _len(len)
+{
+  // Have the kernel read ahead aggressively and drop pages behind the read position.
+  ::madvise(_data, _len, MADV_SEQUENTIAL);
+}
+
+mapped_file_adapter::~mapped_file_adapter() { ::munmap(_data, _len); }
+
+ssize_t mapped_file_adapter::read(char* buffer, size_t num_bytes)
+{
+  num_bytes = std::min(_len - _offset, num_bytes);
+  std::memcpy(buffer, _data + _offset, num_bytes);
+  _offset += num_bytes;
+  return num_bytes;
+}
+
+void mapped_file_adapter::reset() { _offset = 0; }
+
+bool mapped_file_adapter::read_in_place(char*& data, size_t& len)
+{
+  data = _data + _offset;
+  len = _len - _offset;
+  _offset = _len;
+  return true;
+}
+#endif
+
 //
 // gzip_file_adapter
 //
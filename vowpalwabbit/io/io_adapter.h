@@ -49,6 +49,13 @@ struct reader
   /// \throw VW::vw_exception if reader does not support resetting.
   virtual void reset() { THROW("Reset not supported for this io_adapter"); }
 
+  /// Readers whose content is already in memory can hand out the remainder of it without copying. The returned bytes
+  /// stay valid until the reader is destroyed and count as consumed.
+  /// \param data set to the first unread byte
+  /// \param len set to the number of unread bytes
+  /// \returns false if this reader does not support reading in place, in which case read must be used instead.
+  virtual bool read_in_place(char*& /*data*/, size_t& /*len*/) { return false; }
+
   /// \returns true if this reader can be reset, otherwise false
   bool is_resettable() const { return _is_resettable; }
 
@@ -95,8 +102,21 @@ private:
 
 std::unique_ptr<writer> open_file_writer(const std::string& file_path);
 std::unique_ptr<reader> open_file_reader(const std::string& file_path);
+/// Memory maps the file so that it can be read in place. Falls back to open_file_reader if the file cannot be mapped,
+/// for example when it is empty, not a regular file or on platforms without mmap support.
+std::unique_ptr<reader> open_mapped_file_reader(const std::string& file_path);
+/// Writes gzip in the bgzf format, which create_decompressing_reader decompresses in parallel and any gzip reader can
+/// read.
 std::unique_ptr<writer> open_compressed_file_writer(const std::string& file_path);
 std::unique_ptr<reader> open_compressed_file_reader(const std::string& file_path);
+/// Decompresses gzip and, if VW is built with BUILD_ZSTD, zstd input on background threads. Other input is passed
+/// through unchanged. Input made of independently compressed blocks, such as bgzf files or zstd files with many frames,
+/// is decompressed by num_threads workers in parallel. Anything else is decompressed by a single thread ahead of the
+/// caller.
+std::unique_ptr<reader> create_decompressing_reader(std::unique_ptr<reader> compressed, size_t num_threads);
+/// Reads input on a helper thread into depth buffers of buffer_size bytes each, so that reading the next buffer overlaps
+/// with consuming the current one. Helps with input where reads have a high latency, such as files on network mounts.
+std::unique_ptr<reader> create_read_ahead_reader(std::unique_ptr<reader> input, size_t buffer_size, size_t depth);
 std::unique_ptr<reader> open_compressed_stdin();
 std::unique_ptr<writer> open_compressed_stdout();
 std::unique_ptr<reader> open_stdin();
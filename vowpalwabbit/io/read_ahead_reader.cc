@@ -0,0 +1,172 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "io_adapter.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace VW::io;
+
+namespace
+{
+// Reads the input on a helper thread into a ring of buffers so that the caller only waits if it consumes data faster
+// than the input delivers it.
+class read_ahead_reader : public reader
+{
+public:
+  read_ahead_reader(std::unique_ptr<reader> input, size_t buffer_size, size_t depth)
+      : reader(input->is_resettable()), _input(std::move(input))
+  {
+    _buffers.resize(std::max<size_t>(depth, 1));
+    for (auto& b : _buffers) { b.data.resize(std::max<size_t>(buffer_size, 1)); }
+    start();
+  }
+
+  ~read_ahead_reader() override { stop(); }
+
+  ssize_t read(char* buffer, size_t num_bytes) override
+  {
+    std::unique_lock<std::mutex> lock(_mut);
+    _buffer_filled.wait(lock, [this] { return _filled > 0 || _input_done; });
+    if (_filled == 0)
+    {
+      if (_exc) { std::rethrow_exception(_exc); }
+      return _last_result;
+    }
+
+    // Only wait for the first buffer, the rest of the request is served from whatever else is ready.
+    size_t copied = 0;
+    while (copied < num_bytes && _filled > 0)
+    {
+      // The helper thread leaves filled buffers alone until they are handed back.
+      ring_buffer& b = _buffers[_read_index];
+      lock.unlock();
+      const size_t n = std::min(num_bytes - copied, b.size - b.consumed);
+      std::memcpy(buffer + copied, b.data.data() + b.consumed, n);
+      b.consumed += n;
+      copied += n;
+      lock.lock();
+
+      if (b.consumed == b.size)
+      {
+        _read_index = (_read_index + 1) % _buffers.size();
+        _filled--;
+        _room_available.notify_one();
+      }
+    }
+    return static_cast<ssize_t>(copied);
+  }
+
+  void reset() override
+  {
+    stop();
+    _input->reset();
+    start();
+  }
+
+private:
+  struct ring_buffer
+  {
+    std::vector<char> data;
+    size_t size = 0;
+    size_t consumed = 0;
+  };
+
+  void start()
+  {
+    _shutdown = false;
+    _input_done = false;
+    _exc = nullptr;
+    _last_result = 0;
+    _read_index = 0;
+    _filled = 0;
+    _thread = std::thread(&read_ahead_reader::fill, this);
+  }
+
+  void stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      _shutdown = true;
+    }
+    _room_available.notify_all();
+    _thread.join();
+  }
+
+  // Runs on the helper thread until the input is exhausted.
+  void fill()
+  {
+    size_t fill_index = 0;
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(_mut);
+        _room_available.wait(lock, [this] { return _shutdown || _filled < _buffers.size(); });
+        if (_shutdown) { return; }
+      }
+
+      ring_buffer& b = _buffers[fill_index];
+      ssize_t num_read;
+      try
+      {
+        num_read = _input->read(b.data.data(), b.data.size());
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(_mut);
+        _exc = std::current_exception();
+        _input_done = true;
+        _buffer_filled.notify_one();
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(_mut);
+      if (num_read <= 0)
+      {
+        // Errors are passed on as they are once everything before them has been read.
+        _last_result = num_read;
+        _input_done = true;
+        _buffer_filled.notify_one();
+        return;
+      }
+      b.size = static_cast<size_t>(num_read);
+      b.consumed = 0;
+      fill_index = (fill_index + 1) % _buffers.size();
+      _filled++;
+      _buffer_filled.notify_one();
+    }
+  }
+
+  std::unique_ptr<reader> _input;
+  std::vector<ring_buffer> _buffers;
+  std::thread _thread;
+
+  std::mutex _mut;
+  std::condition_variable _buffer_filled;
+  std::condition_variable _room_available;
+  size_t _read_index = 0;
+  size_t _filled = 0;
+  bool _input_done = false;
+  bool _shutdown = false;
+  ssize_t _last_result = 0;
+  std::exception_ptr _exc;
+};
+}  // namespace
+
+namespace VW
+{
+namespace io
+{
+std::unique_ptr<reader> create_read_ahead_reader(std::unique_ptr<reader> input, size_t buffer_size, size_t depth)
+{
+  return std::unique_ptr<reader>(new read_ahead_reader(std::move(input), buffer_size, depth));
+}
+}  // namespace io
+}  // namespace VW
@@ -4,6 +4,8 @@
 #include "io_buf.h"
 #include "io/logger.h"
 
+#include <algorithm>
+
 size_t io_buf::buf_read(char*& pointer, size_t n)
 {
   // return a pointer to the next n bytes.  n must be smaller than the maximum size.
@@ -15,6 +17,7 @@ size_t io_buf::buf_read(char*& pointer, size_t n)
   }
   else  // out of bytes, so refill.
   {
+    if (_buffer.is_view()) { end_view(); }
     if (head != _buffer._begin)  // There exists room to shift.
     {
       // Out of buffer so swap to beginning.
@@ -61,6 +64,11 @@ size_t io_buf::readto(char*& pointer, char terminal)
   }
   else
   {
+    if (_buffer.is_view())
+    {
+      end_view();
+      pointer = _buffer._end;
+    }
     if (_buffer._end == _buffer._end_array)
     {
       _buffer.shift_to_front(head);
@@ -110,6 +118,7 @@ size_t io_buf::copy_to(void* dst, size_t max_size)
 
 void io_buf::replace_buffer(char* buff, size_t capacity)
 {
+  if (_buffer.is_view()) { _buffer.end_view(); }
   if (_buffer._begin != nullptr) { std::free(_buffer._begin); }
 
   _buffer._begin = buff;
@@ -118,6 +127,18 @@ void io_buf::replace_buffer(char* buff, size_t capacity)
   head = buff;
 }
 
+void io_buf::end_view()
+{
+  // The view ends with a partial record, so carry the unread bytes over into the owned buffer.
+  char* unread = head;
+  const size_t unread_len = _buffer._end - head;
+  _buffer.end_view();
+  if (_buffer.capacity() < unread_len) { _buffer.realloc(std::max(unread_len, 2 * _buffer.capacity())); }
+  memcpy(_buffer._begin, unread, unread_len);
+  _buffer._end = _buffer._begin + unread_len;
+  head = _buffer._begin;
+}
+
 void io_buf::flush()
 {
   if (!output_files.empty())
@@ -38,6 +38,11 @@
 ** The interval [head, _buffer._end] may be shifted down to _buffer._begin
 ** if the requested number of bytes to be read is larger than the interval size.
 ** This is done to avoid reallocating arrays as much as possible.
+**
+** When the current input file can be read in place (a memory mapped cache file)
+** and nothing is left in the buffer, the buffer is pointed at the file contents
+** instead of copying them. The owned allocation is parked until the view is
+** exhausted, at which point any unread bytes are copied back into it.
 */
 
 class io_buf
@@ -51,10 +56,38 @@ class io_buf
     char* _end = nullptr;
     char* _end_array = nullptr;
 
-    ~internal_buffer() { std::free(_begin); }
+    // Owned allocation while the buffer is a view over memory owned by a reader.
+    char* _parked_begin = nullptr;
+    char* _parked_end_array = nullptr;
+
+    ~internal_buffer() { std::free(is_view() ? _parked_begin : _begin); }
+
+    bool is_view() const { return _parked_begin != nullptr; }
+
+    void start_view(char* data, size_t len)
+    {
+      assert(!is_view());
+      _parked_begin = _begin;
+      _parked_end_array = _end_array;
+      _begin = data;
+      _end = data + len;
+      _end_array = _end;
+    }
+
+    // Switches back to the owned allocation, which is left empty.
+    void end_view()
+    {
+      assert(is_view());
+      _begin = _parked_begin;
+      _end = _parked_begin;
+      _end_array = _parked_end_array;
+      _parked_begin = nullptr;
+      _parked_end_array = nullptr;
+    }
 
     void realloc(size_t new_capacity)
     {
+      assert(!is_view());
       // This specific internal buffer should only ever grow.
       assert(new_capacity >= capacity());
       const auto old_size = size();
@@ -92,6 +125,8 @@ class io_buf
   std::vector<std::unique_ptr<VW::io::reader>> input_files;
   std::vector<std::unique_ptr<VW::io::writer>> output_files;
 
+  void end_view();
+
 public:
   io_buf()
   {
@@ -138,6 +173,7 @@ public:
 
   void reset_buffer()
   {
+    if (_buffer.is_view()) { _buffer.end_view(); }
     _buffer._end = _buffer._begin;
     head = _buffer._begin;
   }
@@ -161,6 +197,23 @@ public:
 
   ssize_t fill(VW::io::reader* f)
   {
+    if (_buffer.is_view()) { end_view(); }
+    if (head == _buffer._end)
+    {
+      // Nothing left to keep, so the rest of the file can be used directly if the reader supports it.
+      char* data;
+      size_t len;
+      if (f->read_in_place(data, len))
+      {
+        if (len > 0)
+        {
+          _buffer.start_view(data, len);
+          head = _buffer._begin;
+        }
+        return static_cast<ssize_t>(len);
+      }
+    }
+
     // if the loaded values have reached the allocated space
     if (_buffer._end_array - _buffer._end == 0)
     {  // reallocate to twice as much space
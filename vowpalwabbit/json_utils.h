@@ -48,12 +48,17 @@ struct Namespace
 
   void AddFeature(vw* all, const char* key, const char* value)
   {
-    ftrs->push_back(1., VW::chain_hash(*all, key, value, namespace_hash));
+    // Same as VW::chain_hash without copying the key and the value into strings.
+    hash_func_t hasher = all->example_parser->hasher;
+    ftrs->push_back(1., hasher(value, strlen(value), hasher(key, strlen(key), namespace_hash)) & all->parse_mask);
     feature_count++;
 
-    std::stringstream ss;
-    ss << key << "^" << value;
-    if (audit) ftrs->space_names.push_back(audit_strings_ptr(new audit_strings(name, ss.str())));
+    if (audit)
+    {
+      std::stringstream ss;
+      ss << key << "^" << value;
+      ftrs->space_names.push_back(audit_strings_ptr(new audit_strings(name, ss.str())));
+    }
   }
 };
 
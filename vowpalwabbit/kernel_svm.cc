@@ -8,6 +8,8 @@
 #include <cstdio>
 #include <cassert>
 #include <memory>
+#include <algorithm>
+#include <vector>
 
 #include "parse_example.h"
 #include "constant.h"
@@ -24,6 +26,17 @@
 
 #include "io/logger.h"
 
+#if !defined(VW_NO_INLINE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#  define VW_KSVM_AVX2
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    define VW_TARGET_AVX2
+#  else
+// AVX2 only, with FMA enabled the compiler may contract the products and sums of linear_kernel into FMAs.
+#    define VW_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
 namespace logger = VW::io::logger;
 
 #define SVM_KER_LIN 0
@@ -37,13 +50,11 @@ using std::endl;
 
 struct svm_params;
 
-static size_t num_kernel_evals = 0;
-static size_t num_cache_evals = 0;
-
 struct svm_example
 {
   v_array<float> krow;
   flat_example ex;
+  uint64_t last_used;  // svm_params::cache_clock when krow was last read, the least recent rows are evicted first
 
   ~svm_example();
   void init_svm_example(flat_example* fec);
@@ -95,8 +106,12 @@ struct svm_params
   size_t reprocess;
 
   svm_model* model;
-  size_t maxcache;
-  // size_t curcache;
+  size_t maxcache;    // kernel values the rows may hold, from --kernel_cache_mb
+  size_t cache_size;  // kernel values counted by the last trim_cache plus those computed since
+  uint64_t cache_clock;
+  size_t cache_hits;
+  size_t cache_misses;
+  size_t cache_evictions;
 
   svm_example** pool;
   float lambda;
@@ -118,8 +133,8 @@ struct svm_params
     if (all)
     {
       *(all->trace_message) << "Num support = " << model->num_support << endl;
-      *(all->trace_message) << "Number of kernel evaluations = " << num_kernel_evals << " "
-                            << "Number of cache queries = " << num_cache_evals << endl;
+      *(all->trace_message) << "Kernel cache hits = " << cache_hits << " misses = " << cache_misses
+                            << " evicted rows = " << cache_evictions << endl;
       *(all->trace_message) << "Total loss = " << loss_sum << endl;
     }
     if (model) { free_svm_model(model); }
@@ -151,19 +166,21 @@ svm_example::~svm_example()
 }
 
 float kernel_function(const flat_example* fec1, const flat_example* fec2, void* params, size_t kernel_type);
+static void trim_cache(svm_params& params, const svm_example* keep);
 
 int svm_example::compute_kernels(svm_params& params)
 {
   int alloc = 0;
   svm_model* model = params.model;
   size_t n = model->num_support;
+  last_used = ++params.cache_clock;
 
   if (krow.size() < n)
   {
     // computing new kernel values and caching them
-    // if(params->curcache + n > params->maxcache)
-    // trim_cache(params);
-    num_kernel_evals += krow.size();
+    params.cache_hits += krow.size();
+    params.cache_misses += n - krow.size();
+    krow.reserve(n);
     for (size_t i = krow.size(); i < n; i++)
     {
       svm_example* sec = model->support_vec[i];
@@ -171,19 +188,26 @@ int svm_example::compute_kernels(svm_params& params)
       krow.push_back(kv);
       alloc += 1;
     }
+    params.cache_size += alloc;
+    if (params.cache_size > params.maxcache) { trim_cache(params, this); }
   }
   else
-    num_cache_evals += n;
+    params.cache_hits += n;
   return alloc;
 }
 
 int svm_example::clear_kernels()
 {
   int rowsize = static_cast<int>(krow.size());
-  krow.clear();
+  // Release the memory too, the row may not be needed again for a long time.
+  krow.delete_v();
   return -rowsize;
 }
 
+// make_hot_sv moves a support vector to the front, which changes the order of the sums over the support vectors. It
+// is skipped past this many kernel values whatever --kernel_cache_mb is, so the cache does not change what is learned.
+static constexpr size_t max_hot_sv_kernels = size_t(1024) * 1024 * 1024;
+
 static int make_hot_sv(svm_params& params, size_t svi)
 {
   svm_model* model = params.model;
@@ -220,6 +244,7 @@ static int make_hot_sv(svm_params& params, size_t svi)
       float kv = svi_e->krow[j];
       e->krow.push_back(0);
       alloc += 1;
+      params.cache_size++;
       for (size_t i = e->krow.size() - 1; i > 0; --i) e->krow[i] = e->krow[i - 1];
       e->krow[0] = kv;
     }
@@ -227,19 +252,31 @@ static int make_hot_sv(svm_params& params, size_t svi)
   return alloc;
 }
 
-static int trim_cache(svm_params& params)
+// Recounts the cached kernel values and drops the rows of the least recently used support vectors until they fill at
+// most 3/4 of maxcache, so that the next rows computed do not trim again right away. The row of keep is being read and
+// stays.
+static void trim_cache(svm_params& params, const svm_example* keep)
 {
-  int sz = (int)params.maxcache;
   svm_model* model = params.model;
-  size_t n = model->num_support;
-  int alloc = 0;
-  for (size_t i = 0; i < n; i++)
+  std::vector<svm_example*> rows;
+  size_t size = keep->krow.size();
+  for (size_t i = 0; i < model->num_support; i++)
   {
     svm_example* e = model->support_vec[i];
-    sz -= (int)e->krow.size();
-    if (sz < 0) alloc += e->clear_kernels();
+    if (e == keep || e->krow.size() == 0) continue;
+    size += e->krow.size();
+    rows.push_back(e);
   }
-  return alloc;
+
+  std::sort(rows.begin(), rows.end(),
+      [](const svm_example* first, const svm_example* second) { return first->last_used < second->last_used; });
+  const size_t target = params.maxcache - params.maxcache / 4;
+  for (size_t i = 0; i < rows.size() && size > target; i++)
+  {
+    size += rows[i]->clear_kernels();
+    params.cache_evictions++;
+  }
+  params.cache_size = size;
 }
 
 int save_load_flat_example(io_buf& model_file, bool read, flat_example*& fec)
@@ -358,36 +395,76 @@ void save_load(svm_params& params, io_buf& model_file, bool read, bool text)
   save_load_svm_model(params, model_file, read, text);
 }
 
-float linear_kernel(const flat_example* fec1, const flat_example* fec2)
+// Merges the sorted indices of fs_1 and fs_2 from positions idx1 and idx2 until either reaches end1 or end2, adding the
+// products of the values of equal indices to dotprod.
+inline float sparse_dot_scalar(const features& fs_1, const features& fs_2, size_t& idx1, size_t& idx2, size_t end1,
+    size_t end2, float dotprod)
 {
-  float dotprod = 0;
-
-  features& fs_1 = (features&)fec1->fs;
-  features& fs_2 = (features&)fec2->fs;
-  if (fs_2.indicies.size() == 0) return 0.f;
+  while (idx1 < end1 && idx2 < end2)
+  {
+    const uint64_t ec1pos = fs_1.indicies[idx1];
+    const uint64_t ec2pos = fs_2.indicies[idx2];
+    if (ec1pos < ec2pos)
+      idx1++;
+    else if (ec1pos > ec2pos)
+      idx2++;
+    else
+      dotprod += fs_1.values[idx1++] * fs_2.values[idx2++];
+  }
+  return dotprod;
+}
 
-  int numint = 0;
-  for (size_t idx1 = 0, idx2 = 0; idx1 < fs_1.size() && idx2 < fs_2.size(); idx1++)
+#if defined(VW_KSVM_AVX2)
+// Compares blocks of 4 indices of each example against each other in all 4 rotations and skips the block with the
+// smaller last index when nothing matches. Blocks that share an index go through the scalar merge instead, which pairs
+// up repeated indices (flatten_sort_example repeats the first one) and adds the products in the same order, so the
+// result is the same to the bit.
+VW_TARGET_AVX2 float sparse_dot_avx2(const features& fs_1, const features& fs_2)
+{
+  const feature_index* indices_1 = fs_1.indicies.begin();
+  const feature_index* indices_2 = fs_2.indicies.begin();
+  const size_t size_1 = fs_1.size();
+  const size_t size_2 = fs_2.size();
+  float dotprod = 0.f;
+  size_t idx1 = 0;
+  size_t idx2 = 0;
+  while (idx1 + 4 <= size_1 && idx2 + 4 <= size_2)
   {
-    uint64_t ec1pos = fs_1.indicies[idx1];
-    uint64_t ec2pos = fs_2.indicies[idx2];
-    // params.all->opts_n_args.trace_message<<ec1pos<<" "<<ec2pos<<" "<<idx1<<" "<<idx2<<" "<<f->x<<" "<<ec2f->x<< endl;
-    if (ec1pos < ec2pos) continue;
+    const __m256i block_1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices_1 + idx1));
+    const __m256i block_2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices_2 + idx2));
+    __m256i matches = _mm256_cmpeq_epi64(block_1, block_2);
+    matches = _mm256_or_si256(
+        matches, _mm256_cmpeq_epi64(block_1, _mm256_permute4x64_epi64(block_2, _MM_SHUFFLE(0, 3, 2, 1))));
+    matches = _mm256_or_si256(
+        matches, _mm256_cmpeq_epi64(block_1, _mm256_permute4x64_epi64(block_2, _MM_SHUFFLE(1, 0, 3, 2))));
+    matches = _mm256_or_si256(
+        matches, _mm256_cmpeq_epi64(block_1, _mm256_permute4x64_epi64(block_2, _MM_SHUFFLE(2, 1, 0, 3))));
+
+    if (_mm256_testz_si256(matches, matches) == 0)
+    { dotprod = sparse_dot_scalar(fs_1, fs_2, idx1, idx2, idx1 + 4, idx2 + 4, dotprod); }
+    // Without a match the last indices differ, and the scalar merge would move past the smaller one's block too.
+    else if (indices_1[idx1 + 3] < indices_2[idx2 + 3])
+      idx1 += 4;
+    else
+      idx2 += 4;
+  }
+  _mm256_zeroupper();
+  return sparse_dot_scalar(fs_1, fs_2, idx1, idx2, size_1, size_2, dotprod);
+}
+#endif
 
-    while (ec1pos > ec2pos && ++idx2 < fs_2.size()) ec2pos = fs_2.indicies[idx2];
+float linear_kernel(const flat_example* fec1, const flat_example* fec2)
+{
+  const features& fs_1 = fec1->fs;
+  const features& fs_2 = fec2->fs;
+  if (fs_2.indicies.size() == 0) return 0.f;
 
-    if (ec1pos == ec2pos)
-    {
-      // params.all->opts_n_args.trace_message<<ec1pos<<" "<<ec2pos<<" "<<idx1<<" "<<idx2<<" "<<f->x<<"
-      // "<<ec2f->x<< endl;
-      numint++;
-      dotprod += fs_1.values[idx1] * fs_2.values[idx2];
-      ++idx2;
-    }
-  }
-  // params.all->opts_n_args.trace_message<< endl;
-  // params.all->opts_n_args.trace_message<<"numint = "<<numint<<" dotprod = "<<dotprod<< endl;
-  return dotprod;
+#if defined(VW_KSVM_AVX2)
+  if (GD::simd::available()) { return sparse_dot_avx2(fs_1, fs_2); }
+#endif
+  size_t idx1 = 0;
+  size_t idx2 = 0;
+  return sparse_dot_scalar(fs_1, fs_2, idx1, idx2, fs_1.size(), fs_2.size(), 0.f);
 }
 
 float poly_kernel(const flat_example* fec1, const flat_example* fec2, int power)
@@ -739,7 +816,7 @@ void train(svm_params& params)
             {
               if (!overshoot && max_pos == (size_t)model_pos && max_pos > 0 && j == 0)
                 *params.all->trace_message << "Shouldn't reprocess right after process!!!" << endl;
-              if (max_pos * model->num_support <= params.maxcache) make_hot_sv(params, max_pos);
+              if (max_pos * model->num_support <= max_hot_sv_kernels) make_hot_sv(params, max_pos);
               update(params, max_pos);
             }
           }
@@ -772,12 +849,11 @@ void learn(svm_params& params, single_learner&, example& ec)
     ec.pred.scalar = score;
     ec.loss = std::max(0.f, 1.f - score * ec.l.simple.label);
     params.loss_sum += ec.loss;
-    if (params.all->training && ec.example_counter % 100 == 0) trim_cache(params);
     if (params.all->training && ec.example_counter % 1000 == 0 && ec.example_counter >= 2)
     {
       *params.all->trace_message << "Number of support vectors = " << params.model->num_support << endl;
-      *params.all->trace_message << "Number of kernel evaluations = " << num_kernel_evals << " "
-                                 << "Number of cache queries = " << num_cache_evals << " loss sum = " << params.loss_sum
+      *params.all->trace_message << "Kernel cache hits = " << params.cache_hits << " misses = " << params.cache_misses
+                                 << " evicted rows = " << params.cache_evictions << " loss sum = " << params.loss_sum
                                  << " " << params.model->alpha[params.model->num_support - 1] << " "
                                  << params.model->alpha[params.model->num_support - 2] << endl;
     }
@@ -798,6 +874,7 @@ VW::LEARNER::base_learner* kernel_svm_setup(options_i& options, vw& all)
   std::string kernel_type;
   float bandwidth = 1.f;
   int degree = 2;
+  uint64_t kernel_cache_mb = 4096;
 
   bool ksvm = false;
 
@@ -815,7 +892,10 @@ VW::LEARNER::base_learner* kernel_svm_setup(options_i& options, vw& all)
                .default_value("linear")
                .help("type of kernel (rbf or linear (default))"))
       .add(make_option("bandwidth", bandwidth).keep().default_value(1.f).help("bandwidth of rbf kernel"))
-      .add(make_option("degree", degree).keep().default_value(2).help("degree of poly kernel"));
+      .add(make_option("degree", degree).keep().default_value(2).help("degree of poly kernel"))
+      .add(make_option("kernel_cache_mb", kernel_cache_mb)
+               .default_value(4096)
+               .help("megabytes of kernel values to cache, the least recently used rows are dropped beyond it"));
 
   if (!options.add_parse_and_check_necessary(new_options)) { return nullptr; }
 
@@ -826,7 +906,7 @@ VW::LEARNER::base_learner* kernel_svm_setup(options_i& options, vw& all)
   params->model = &calloc_or_throw<svm_model>();
   new (params->model) svm_model();
   params->model->num_support = 0;
-  params->maxcache = 1024 * 1024 * 1024;
+  params->maxcache = static_cast<size_t>(kernel_cache_mb * 1024 * 1024 / sizeof(float));
   params->loss_sum = 0.;
   params->all = &all;
   params->_random_state = all.get_random_state();
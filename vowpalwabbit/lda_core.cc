@@ -27,6 +27,7 @@
 
 #include "io/logger.h"
 #include "shared_data.h"
+#include "worker_pool.h"
 
 #include <boost/version.hpp>
 #include <boost/math/special_functions/digamma.hpp>
@@ -55,6 +56,14 @@ public:
   bool operator<(const index_feature b) const { return f.weight_index < b.f.weight_index; }
 };
 
+// Scratch space for the E-step of one document, one per thread running it.
+struct gamma_scratch
+{
+  v_array<float> new_gamma;
+  v_array<float> old_gamma;
+  v_array<float> Elogtheta;
+};
+
 struct lda
 {
   size_t topics;
@@ -67,7 +76,6 @@ struct lda
 
   size_t finish_example_count;
 
-  v_array<float> Elogtheta;
   v_array<float> decay_levels;
   v_array<float> total_new;
   v_array<example *> examples;
@@ -77,6 +85,11 @@ struct lda
   v_array<float> v;
   std::vector<index_feature> sorted_features;
 
+  // Runs the E-step of the documents in a minibatch on several threads, set with --lda_threads.
+  std::unique_ptr<VW::worker_pool> estep_pool;
+  std::vector<gamma_scratch> scratch;
+  std::vector<float> doc_scores;
+
   bool compute_coherence_metrics;
 
   // size by 1 << bits
@@ -654,21 +667,16 @@ static inline float find_cw(lda &l, float *u_for_w, float *v)
   return 1.0f / std::inner_product(u_for_w, u_for_w + l.topics, v, 0.0f);
 }
 
-namespace
-{
-// Effectively, these are static and not visible outside the compilation unit.
-v_array<float> new_gamma = v_init<float>();
-v_array<float> old_gamma = v_init<float>();
-}  // namespace
-
 // Returns an estimate of the part of the variational bound that
 // doesn't have to do with beta for the entire corpus for the current
 // setting of lambda based on the document passed in. The value is
 // divided by the total number of words in the document This can be
 // used as a (possibly very noisy) estimate of held-out likelihood.
-float lda_loop(lda &l, v_array<float> &Elogtheta, float *v, example *ec, float)
+float lda_loop(lda &l, gamma_scratch &scratch, float *v, example *ec)
 {
   parameters &weights = l.all->weights;
+  v_array<float> &new_gamma = scratch.new_gamma;
+  v_array<float> &old_gamma = scratch.old_gamma;
   new_gamma.clear();
   old_gamma.clear();
 
@@ -715,7 +723,7 @@ float lda_loop(lda &l, v_array<float> &Elogtheta, float *v, example *ec, float)
   ec->pred.scalars.resize_but_with_stl_behavior(l.topics);
   memcpy(ec->pred.scalars.begin(), new_gamma.begin(), l.topics * sizeof(float));
 
-  score += theta_kl(l, Elogtheta, new_gamma.begin());
+  score += theta_kl(l, scratch.Elogtheta, new_gamma.begin());
 
   return score / doc_length;
 }
@@ -902,9 +910,21 @@ void learn_batch(lda &l)
     l.expdigammify_2(*l.all, u_for_w, l.digammas.begin());
   }
 
+  // The documents are independent given lambda. Each writes only its own row of v and its prediction, the loss is
+  // summed afterwards in document order so it does not depend on the number of threads.
+  l.doc_scores.resize(batch_size);
+  auto estep = [&l](size_t d, size_t thread) {
+    l.doc_scores[d] = lda_loop(l, l.scratch[thread], &(l.v[d * l.all->lda]), l.examples[d]);
+  };
+  if (l.estep_pool != nullptr) { l.estep_pool->for_each(batch_size, estep); }
+  else
+  {
+    for (size_t d = 0; d < batch_size; d++) { estep(d, 0); }
+  }
+
   for (size_t d = 0; d < batch_size; d++)
   {
-    float score = lda_loop(l, l.Elogtheta, &(l.v[d * l.all->lda]), l.examples[d], l.all->power_t);
+    float score = l.doc_scores[d];
     if (l.all->audit) GD::print_audit_features(*l.all, *l.examples[d]);
     // If the doc is empty, give it loss of 0.
     if (l.doc_lengths[d] > 0)
@@ -1277,6 +1297,7 @@ VW::LEARNER::base_learner *lda_setup(options_i &options, vw &all)
   auto ld = scoped_calloc_or_throw<lda>();
   option_group_definition new_options("Latent Dirichlet Allocation");
   int math_mode;
+  uint64_t lda_threads;
   new_options.add(make_option("lda", ld->topics).keep().necessary().help("Run lda with <int> topics"))
       .add(make_option("lda_alpha", ld->lda_alpha)
                .keep()
@@ -1290,7 +1311,10 @@ VW::LEARNER::base_learner *lda_setup(options_i &options, vw &all)
       .add(make_option("lda_epsilon", ld->lda_epsilon).default_value(0.001f).help("Loop convergence threshold"))
       .add(make_option("minibatch", ld->minibatch).default_value(1).help("Minibatch size, for LDA"))
       .add(make_option("math-mode", math_mode).default_value(USE_SIMD).help("Math mode: simd, accuracy, fast-approx"))
-      .add(make_option("metrics", ld->compute_coherence_metrics).help("Compute metrics"));
+      .add(make_option("metrics", ld->compute_coherence_metrics).help("Compute metrics"))
+      .add(make_option("lda_threads", lda_threads)
+               .default_value(1)
+               .help("Number of threads running the per-document E-step of a minibatch"));
 
   if (!options.add_parse_and_check_necessary(new_options)) return nullptr;
 
@@ -1299,6 +1323,12 @@ VW::LEARNER::base_learner *lda_setup(options_i &options, vw &all)
 
   ld->finish_example_count = 0;
 
+  if (lda_threads == 0) { THROW("lda_threads should be positive"); }
+  // Every word of the minibatch has been looked up by the M-step preparation before the E-step reads it, so the
+  // threads never insert into sparse weights.
+  if (lda_threads > 1) { ld->estep_pool = VW::make_unique<VW::worker_pool>(lda_threads); }
+  ld->scratch.resize(lda_threads);
+
   all.lda = (uint32_t)ld->topics;
   ld->sorted_features = std::vector<index_feature>();
   ld->total_lambda_init = false;
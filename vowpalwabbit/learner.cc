@@ -7,6 +7,14 @@
 #include "vw.h"
 #include "parse_regressor.h"
 #include "parse_dispatch_loop.h"
+#include "queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #define CASE(type) \
   case type:       \
@@ -134,6 +142,184 @@ private:
   std::vector<vw*> _all;
 };
 
+// set_minmax of the --learner_threads instances, which learn concurrently and share the label range.
+std::mutex label_range_lock;
+void set_minmax_locked(shared_data* sd, float label)
+{
+  std::lock_guard<std::mutex> lock(label_range_lock);
+  set_mm(sd, label);
+}
+
+// hogwild_learners - learner threads for --learner_threads. The first thread learns with the master instance, the
+// others with instances seeded from it, so each has its own reduction stack but all update the same weights without
+// locking. The shared_data and the progress output are only updated under a lock.
+class hogwild_learners
+{
+public:
+  hogwild_learners(vw& master) : _master(master), _set_minmax(master.set_minmax)
+  {
+    static const std::vector<std::string> input_and_output_options = {"data", "cache", "cache_file", "kill_cache",
+        "compressed", "passes", "predictions", "raw_predictions", "final_regressor", "readable_model", "invert_hash",
+        "save_per_pass", "output_feature_regularizer_binary", "output_feature_regularizer_text", "learner_threads"};
+
+    _learners.resize(master.learner_threads);
+    _learners[0].all = &master;
+    for (size_t i = 1; i < _learners.size(); ++i)
+    { _learners[i].all = VW::seed_vw_model(&master, "--quiet", input_and_output_options, nullptr, nullptr); }
+    for (auto& learner : _learners)
+    {
+      if (_set_minmax != noop_mm) { learner.all->set_minmax = set_minmax_locked; }
+      learner.examples.reset(new VW::spsc_ptr_queue<example>(queue_size));
+      learner_thread* target = &learner;
+      learner.thread = std::thread([this, target] { run(*target); });
+    }
+  }
+
+  ~hogwild_learners()
+  {
+    for (auto& learner : _learners) { learner.examples->set_done(); }
+    for (auto& learner : _learners) { learner.thread.join(); }
+    for (size_t i = 1; i < _learners.size(); ++i) { VW::finish(*_learners[i].all); }
+    _master.set_minmax = _set_minmax;
+  }
+
+  hogwild_learners(const hogwild_learners&) = delete;
+  hogwild_learners& operator=(const hogwild_learners&) = delete;
+
+  vw& get_master() const { return _master; }
+
+  void learn(example& ec)
+  {
+    rethrow_learner_exception();
+    ++_dispatched;
+    _learners[_next].examples->push(&ec);
+    _next = (_next + 1) % _learners.size();
+  }
+
+  // Blocks until every example handed to learn has been learned from and returned to the pool.
+  void wait_idle()
+  {
+    {
+      std::unique_lock<std::mutex> lock(_idle_lock);
+      _waiting = true;
+      _idle.wait(lock, [this] { return _finished.load() == _dispatched; });
+      _waiting = false;
+    }
+    rethrow_learner_exception();
+  }
+
+  // Only the master ends the pass, as the others would summarize the holdout set of the shared_data before it. They
+  // are given its pass number and learning rate.
+  void end_pass(example& ec)
+  {
+    VW::LEARNER::end_pass(ec, _master);
+    for (size_t i = 1; i < _learners.size(); ++i)
+    {
+      _learners[i].all->current_pass = _master.current_pass;
+      _learners[i].all->eta = _master.eta;
+    }
+  }
+
+private:
+  // Room for a few examples per thread so that the dispatcher does not wait on every push.
+  static constexpr size_t queue_size = 64;
+
+  struct learner_thread
+  {
+    vw* all = nullptr;
+    std::unique_ptr<VW::spsc_ptr_queue<example>> examples;
+    std::thread thread;
+  };
+
+  void run(learner_thread& learner)
+  {
+    example* ec;
+    while ((ec = learner.examples->pop()) != nullptr)
+    {
+      bool learned = false;
+      try
+      {
+        // After a failure the remaining examples are only returned to the pool so that the dispatcher never blocks.
+        if (!_failed.load())
+        {
+          learner.all->learn(*ec);
+          // Finishing the example accounts it in the shared_data and prints the progress.
+          std::lock_guard<std::mutex> lock(_shared_data_lock);
+          as_singleline(learner.all->l)->finish_example(*learner.all, *ec);
+          learned = true;
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(_idle_lock);
+        if (!_failed.exchange(true)) { _exc_ptr = std::current_exception(); }
+      }
+      // A seeded instance does not own the example, so finishing it there did not return it to the pool.
+      if (learner.all != &_master || !learned) { VW::finish_example(_master, *ec); }
+
+      _finished++;
+      if (_waiting.load())
+      {
+        std::lock_guard<std::mutex> lock(_idle_lock);
+        _idle.notify_one();
+      }
+    }
+  }
+
+  void rethrow_learner_exception()
+  {
+    if (!_failed.load()) { return; }
+    std::lock_guard<std::mutex> lock(_idle_lock);
+    if (_exc_ptr)
+    {
+      std::exception_ptr exc_ptr = nullptr;
+      std::swap(exc_ptr, _exc_ptr);
+      std::rethrow_exception(exc_ptr);
+    }
+  }
+
+  vw& _master;
+  void (*_set_minmax)(shared_data*, float);
+  std::vector<learner_thread> _learners;
+  size_t _next = 0;
+  size_t _dispatched = 0;
+  std::atomic<size_t> _finished{0};
+  std::atomic<bool> _waiting{false};
+  std::atomic<bool> _failed{false};
+  std::exception_ptr _exc_ptr;
+  std::mutex _shared_data_lock;
+  std::mutex _idle_lock;
+  std::condition_variable _idle;
+};
+
+// hogwild_context - hands learn_ex to the next learner thread. Passes end and the model is saved by the master once
+// the examples in flight are done.
+class hogwild_context
+{
+public:
+  hogwild_context(hogwild_learners& learners) : _learners(learners) {}
+
+  vw& get_master() const { return _learners.get_master(); }
+
+  template <class T, void (*process_impl)(T&, vw&)>
+  void process(T& ec)
+  {
+    if (process_impl == learn_ex) { _learners.learn(ec); }
+    else
+    {
+      _learners.wait_idle();
+      if (process_impl == end_pass) { _learners.end_pass(ec); }
+      else
+      {
+        process_impl(ec, get_master());
+      }
+    }
+  }
+
+private:
+  hogwild_learners& _learners;
+};
+
 // single_example_handler / multi_example_handler - consumer classes with on_example handle method, incapsulating
 // creation of example / multi_ex and passing it to context.process
 template <typename context_type>
@@ -200,7 +386,16 @@ public:
   {
     if (try_complete_multi_ex(ec))
     {
-      _context.template process<multi_ex, learn_multi_ex>(ec_seq);
+      try
+      {
+        _context.template process<multi_ex, learn_multi_ex>(ec_seq);
+      }
+      catch (...)
+      {
+        // Otherwise the destructor would learn from them again while the exception unwinds.
+        ec_seq.clear();
+        throw;
+      }
       ec_seq.clear();
     }
   }
@@ -275,6 +470,29 @@ void generic_driver(const std::vector<vw*>& all)
   generic_driver(examples, context);
 }
 
+void generic_driver_hogwild(vw& all)
+{
+  static const std::vector<std::string> lock_free_reductions = {"gd", "ftrl", "scorer", "oaa", "binary"};
+  for (const auto& reduction : all.enabled_reductions)
+  {
+    if (std::find(lock_free_reductions.begin(), lock_free_reductions.end(), reduction) == lock_free_reductions.end())
+    { THROW("--learner_threads does not support the " << reduction << " reduction"); }
+  }
+  if (all.l->is_multiline) { THROW("--learner_threads only supports single line reductions"); }
+  if (all.weights.sparse) { THROW("--learner_threads cannot be used with --sparse_weights"); }
+  if (all.all_reduce != nullptr) { THROW("--learner_threads cannot be used with --span_server or other all_reduce"); }
+  if (!all.final_prediction_sink.empty() || all.raw_prediction != nullptr)
+  { THROW("--learner_threads does not keep examples in order and cannot be used with -p or -r"); }
+
+  hogwild_learners learners(all);
+  hogwild_context context(learners);
+  ready_examples_queue examples(all);
+  single_example_handler<hogwild_context> handler(context);
+  process_examples(examples, handler);
+  learners.wait_idle();
+  drain_examples(all);
+}
+
 template <typename handler_type>
 void generic_driver_onethread(vw& all)
 {
@@ -297,6 +515,23 @@ void generic_driver_onethread(vw& all)
     generic_driver_onethread<single_example_handler<single_instance_context>>(all);
 }
 
+template <typename handler_type>
+void process_parsed_examples(vw& all, v_array<example*>& examples)
+{
+  single_instance_context context(all);
+  handler_type handler(context);
+  custom_examples_queue examples_queue(examples);
+  process_examples(examples_queue, handler);
+}
+
+void process_parsed_examples(vw& all, v_array<example*>& examples)
+{
+  if (all.l->is_multiline)
+    process_parsed_examples<multi_example_handler<single_instance_context>>(all, examples);
+  else
+    process_parsed_examples<single_example_handler<single_instance_context>>(all, examples);
+}
+
 float recur_sensitivity(void*, base_learner& base, example& ec) { return base.sensitivity(ec); }
 
 }  // namespace LEARNER
@@ -125,7 +125,14 @@ struct finish_example_data
 
 void generic_driver(vw& all);
 void generic_driver(const std::vector<vw*>& alls);
+// Learns with all.learner_threads threads that update the shared dense weights without locking, in the style of
+// Hogwild!. Examples are learned from out of order, so no predictions are written.
+void generic_driver_hogwild(vw& all);
 void generic_driver_onethread(vw& all);
+// Learns from or predicts on examples the caller parsed and set up, in order, the same way generic_driver does. For
+// multiline reductions a multi_ex still open after the last example is completed. When it throws, the examples it did
+// not finish are left in use for the caller to finish.
+void process_parsed_examples(vw& all, v_array<example*>& examples);
 
 inline void noop_save_load(void*, io_buf&, bool, bool) {}
 inline void noop_persist_metrics(void*, std::vector<std::tuple<std::string, size_t>>&) {}
@@ -99,20 +99,27 @@ int main(int argc, char* argv[])
       return 0;
     }
 
-    if (should_use_onethread)
+    if (all.example_parser->daemon_server != nullptr)
     {
-      if (alls.size() == 1)
+      all.example_parser->daemon_server->run();
+    }
+    else if (should_use_onethread)
+    {
+      if (alls.size() == 1 && all.learner_threads == 1)
         VW::LEARNER::generic_driver_onethread(all);
       else
         THROW("--onethread doesn't make sense with multiple learners");
     }
     else
     {
+      if (alls.size() > 1 && all.learner_threads > 1) THROW("--learner_threads cannot be used with multiple learners");
       VW::start_parser(all);
-      if (alls.size() == 1)
-        VW::LEARNER::generic_driver(all);
-      else
+      if (alls.size() > 1)
         VW::LEARNER::generic_driver(alls);
+      else if (all.learner_threads > 1)
+        VW::LEARNER::generic_driver_hogwild(all);
+      else
+        VW::LEARNER::generic_driver(all);
       VW::end_parser(all);
     }
 
@@ -0,0 +1,211 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "parallel_parser.h"
+
+#include <algorithm>
+
+#include "global_data.h"
+#include "parse_example.h"
+#include "parser.h"
+
+namespace VW
+{
+parallel_parser::parallel_parser(vw& all, std::unique_ptr<input_format> format, size_t num_threads)
+    : _all(all), _format(std::move(format)), _num_threads(std::max<size_t>(num_threads, 1))
+{
+  // Without workers the chunk being handed out is the only one read ahead.
+  _max_in_flight = _num_threads > 1 ? 2 * _num_threads : 1;
+}
+
+parallel_parser::~parallel_parser()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mut);
+    _shutdown = true;
+  }
+  _work_available.notify_all();
+  for (auto& worker : _workers) { worker.join(); }
+
+  // Workers drain the pending queue before exiting so every in flight chunk is complete at this point.
+  reset();
+}
+
+void parallel_parser::start_workers()
+{
+  // The label parser and hasher are only finalized once all reductions are set up, so the per worker scratch parsers
+  // are created on first use rather than at construction.
+  auto* p = _all.example_parser;
+  _next_example_index = p->end_parsed_examples.load();
+  for (size_t i = 0; i < _num_threads; i++)
+  {
+    auto scratch = VW::make_unique<parser>(0, p->strict_parse);
+    scratch->lbl_parser = p->lbl_parser;
+    scratch->hasher = p->hasher;
+    scratch->_shared_data = p->_shared_data;
+    scratch->audit = p->audit;
+    scratch->sorted_cache = p->sorted_cache;
+    if (p->hash_cache_size > 0)
+    { scratch->hash_cache = VW::make_unique<VW::hash_cache>(p->hash_cache_size, p->hash_cache_stats); }
+    _scratch_parsers.push_back(std::move(scratch));
+  }
+
+  if (_num_threads > 1)
+  {
+    for (auto& scratch : _scratch_parsers)
+    { _workers.emplace_back(&parallel_parser::worker_loop, this, scratch.get()); }
+  }
+}
+
+void parallel_parser::worker_loop(parser* scratch)
+{
+  while (true)
+  {
+    chunk* c = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(_mut);
+      _work_available.wait(lock, [&] { return _shutdown || !_pending.empty(); });
+      if (_pending.empty()) { return; }
+      c = _pending.front();
+      _pending.pop_front();
+    }
+
+    parse_chunk(*c, *scratch);
+
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      c->parsed = true;
+    }
+    _chunk_parsed.notify_all();
+  }
+}
+
+void parallel_parser::parse_chunk(chunk& c, parser& scratch)
+{
+  try
+  {
+    _format->parse_chunk(_all, c, scratch);
+  }
+  catch (...)
+  {
+    c.exc = std::current_exception();
+  }
+  if (scratch.hash_cache != nullptr) { scratch.hash_cache->flush_stats(); }
+}
+
+example* parallel_parser::next_target_example()
+{
+  if (_spare.empty()) { return &VW::get_unused_example(&_all); }
+  auto* ex = _spare.back();
+  _spare.pop_back();
+  return ex;
+}
+
+std::unique_ptr<parallel_parser::chunk> parallel_parser::read_chunk()
+{
+  auto c = VW::make_unique<chunk>();
+  c->first_example_index = _next_example_index;
+  _format->read_chunk(_all, *c);
+  if (c->consumed.empty()) { _input_exhausted = true; }
+  for (size_t i = 0; i < c->consumed.size(); i++) { c->examples.push_back(next_target_example()); }
+  _next_example_index += c->examples.size();
+  return c;
+}
+
+int parallel_parser::read(v_array<example*>& examples)
+{
+  if (_scratch_parsers.empty()) { start_workers(); }
+
+  if (_current == nullptr || _current_index >= _current->num_parsed)
+  {
+    if (_current != nullptr && _current->exc)
+    {
+      auto exc = _current->exc;
+      release_examples(_current->examples, _current_index);
+      _current.reset();
+      std::rethrow_exception(exc);
+    }
+    _current.reset();
+
+    while (_in_flight.size() < _max_in_flight && !_input_exhausted)
+    {
+      auto c = read_chunk();
+      if (c->examples.empty()) { break; }
+      if (_workers.empty())
+      {
+        parse_chunk(*c, *_scratch_parsers[0]);
+        c->parsed = true;
+      }
+      else
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mut);
+          _pending.push_back(c.get());
+        }
+        _work_available.notify_one();
+      }
+      _in_flight.push_back(std::move(c));
+    }
+
+    if (_in_flight.empty())
+    {
+      examples[0]->is_newline = true;
+      return 0;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(_mut);
+      _chunk_parsed.wait(lock, [&] { return _in_flight.front()->parsed; });
+    }
+    _current = std::move(_in_flight.front());
+    _in_flight.pop_front();
+    _current_index = 0;
+
+    // An exception on the very first line of the chunk, surface it right away.
+    if (_current->num_parsed == 0) { return read(examples); }
+  }
+
+  // The caller supplied a fresh example, keep it as the target for a future line and hand back a parsed one instead.
+  _spare.push_back(examples[0]);
+  examples[0] = _current->examples[_current_index];
+  _current->examples[_current_index] = nullptr;
+  return static_cast<int>(_current->consumed[_current_index++]);
+}
+
+void parallel_parser::release_examples(std::vector<example*>& examples, size_t from)
+{
+  for (size_t i = from; i < examples.size(); i++)
+  {
+    if (examples[i] != nullptr) { VW::clean_example(_all, *examples[i], false); }
+  }
+  examples.clear();
+}
+
+void parallel_parser::reset()
+{
+  {
+    std::unique_lock<std::mutex> lock(_mut);
+    _chunk_parsed.wait(lock, [&] {
+      return std::all_of(
+          _in_flight.begin(), _in_flight.end(), [](const std::unique_ptr<chunk>& c) { return c->parsed; });
+    });
+  }
+
+  if (_current != nullptr) { release_examples(_current->examples, _current_index); }
+  _current.reset();
+  _current_index = 0;
+  for (auto& c : _in_flight) { release_examples(c->examples, 0); }
+  _in_flight.clear();
+  release_examples(_spare, 0);
+
+  _input_exhausted = false;
+  // The end of pass example is dispatched right after the input is reset.
+  _next_example_index = _all.example_parser->end_parsed_examples.load() + 1;
+}
+}  // namespace VW
+
+int read_features_parallel(vw* all, v_array<example*>& examples)
+{
+  return all->example_parser->parallel_reader->read(examples);
+}
@@ -0,0 +1,125 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Mutex and CV cannot be used in managed C++, tell the compiler that this is unmanaged even if included in a managed
+// project.
+#ifdef _M_CEE
+#  pragma managed(push, off)
+#  undef _M_CEE
+#  include <mutex>
+#  include <condition_variable>
+#  define _M_CEE 001
+#  pragma managed(pop)
+#else
+#  include <mutex>
+#  include <condition_variable>
+#endif
+
+#include "v_array.h"
+
+struct vw;
+struct parser;
+struct example;
+
+namespace VW
+{
+/**
+ * Parses input on a pool of worker threads.
+ *
+ * The parse thread remains the only consumer of the input io_buf. It cuts the input into chunks which are turned into
+ * examples by the workers, and hands the finished examples back to parse_dispatch one at a time in their original
+ * input order. Everything that depends on order (holdout, cache writing, setup_example) therefore still runs on the
+ * parse thread. How the input is cut and parsed is up to the input_format.
+ *
+ * With a single thread chunks are parsed on the parse thread itself as soon as they are read.
+ */
+class parallel_parser
+{
+public:
+  struct chunk
+  {
+    std::vector<char> data;
+    // offset into data, length of each item and the number of bytes consumed from the input for it
+    std::vector<size_t> offsets;
+    std::vector<size_t> lengths;
+    std::vector<size_t> consumed;
+    // one target example per item
+    std::vector<example*> examples;
+    uint64_t first_example_index = 0;
+    // examples[0, num_parsed) are valid, if exc is set it was thrown while parsing examples[num_parsed]
+    size_t num_parsed = 0;
+    std::exception_ptr exc;
+    bool parsed = false;
+  };
+
+  struct input_format
+  {
+    virtual ~input_format() = default;
+
+    // Called on the parse thread. Reads the next items from the input into c. Leaving c empty signals the end of the
+    // input.
+    virtual void read_chunk(vw& all, chunk& c) = 0;
+
+    // Called on a worker thread. Parses the items of c into c.examples, incrementing c.num_parsed after each one.
+    // scratch is private to the calling thread.
+    virtual void parse_chunk(vw& all, chunk& c, parser& scratch) = 0;
+  };
+
+  parallel_parser(vw& all, std::unique_ptr<input_format> format, size_t num_threads);
+  ~parallel_parser();
+
+  parallel_parser(const parallel_parser&) = delete;
+  parallel_parser& operator=(const parallel_parser&) = delete;
+
+  // Same contract as parser::reader. Replaces examples[0] with the next example in input order.
+  int read(v_array<example*>& examples);
+
+  // Discards any read ahead examples and returns them to the example pool. Must be called whenever the input is reset.
+  void reset();
+
+  size_t num_threads() const { return _num_threads; }
+
+private:
+  void start_workers();
+  void worker_loop(parser* scratch);
+  void parse_chunk(chunk& c, parser& scratch);
+  std::unique_ptr<chunk> read_chunk();
+  example* next_target_example();
+  void release_examples(std::vector<example*>& examples, size_t from);
+
+  vw& _all;
+  std::unique_ptr<input_format> _format;
+  size_t _num_threads;
+  size_t _max_in_flight;
+
+  std::vector<std::thread> _workers;
+  std::vector<std::unique_ptr<parser>> _scratch_parsers;
+
+  std::mutex _mut;
+  std::condition_variable _work_available;
+  std::condition_variable _chunk_parsed;
+  std::deque<chunk*> _pending;
+  bool _shutdown = false;
+
+  // Only touched by the parse thread.
+  std::deque<std::unique_ptr<chunk>> _in_flight;
+  std::unique_ptr<chunk> _current;
+  size_t _current_index = 0;
+  std::vector<example*> _spare;
+  uint64_t _next_example_index = 0;
+  bool _input_exhausted = false;
+};
+}  // namespace VW
+
+int read_features_parallel(vw* all, v_array<example*>& examples);
@@ -433,6 +433,10 @@ input_options parse_source(vw& all, options_i& options)
                .help("in persistent daemon mode, do not run in the background"))
       .add(make_option("port", parsed_options.port).help("port to listen on; use 0 to pick unused port"))
       .add(make_option("num_children", all.num_children).help("number of children for persistent daemon mode"))
+      .add(make_option("daemon_threads", parsed_options.daemon_threads)
+               .default_value(0)
+               .help("Serve all daemon connections from one process with this many worker threads instead of forking "
+                     "--num_children children that serve one connection each. Linux only."))
       .add(make_option("pid_file", parsed_options.pid_file).help("Write pid file in persistent daemon mode"))
       .add(make_option("port_file", parsed_options.port_file).help("Write port used in persistent daemon mode"))
       .add(make_option("cache", parsed_options.cache).short_name("c").help("Use a cache.  The default is <data>.cache"))
@@ -457,7 +461,33 @@ input_options parse_source(vw& all, options_i& options)
                      "A^B^C. Note: this will become the default in a future version, so enabling this option will "
                      "migrate you to the new behavior and silence the warning."))
       .add(make_option("flatbuffer", parsed_options.flatbuffer)
-               .help("data file will be interpreted as a flatbuffer file"));
+               .help("data file will be interpreted as a flatbuffer file"))
+      .add(make_option("parse_threads", parsed_options.parse_threads)
+               .default_value(1)
+               .help("Number of threads used to parse text format input and to decode block format caches. Examples "
+                     "still reach the learner in input order. Ignored for JSON, flatbuffer and daemon input."))
+      .add(make_option("cache_block_size", parsed_options.cache_block_size)
+               .default_value(0)
+               .help("Create cache files in the block format with this many examples per block, 0 uses the stream "
+                     "format. Blocks are decoded in parallel with --parse_threads and compressed with --compressed."))
+      .add(make_option("compression", parsed_options.compression)
+               .default_value("gzip")
+               .help("Compression used for block format caches with --compressed: gzip or zstd. Compressed input is "
+                     "recognized either way."))
+      .add(make_option("read_ahead", parsed_options.read_ahead)
+               .default_value(0)
+               .help("Read data and cache files on a helper thread, this many buffers ahead of the parser. 0 reads "
+                     "them when the parser needs more input. Helps when reads are slow, e.g. on network mounts."))
+      .add(make_option("read_ahead_kb", parsed_options.read_ahead_kb)
+               .default_value(1024)
+               .help("Size in KiB of each --read_ahead buffer."))
+      .add(make_option("example_storage_stats", parsed_options.example_storage_stats)
+               .help("Report the most storage a single example used and kept between uses at the end of the run."))
+      .add(make_option("hash_cache", parsed_options.hash_cache)
+               .default_value(0)
+               .help("Remember the hashes of this many recent feature and namespace names per text parser thread "
+                     "instead of hashing them again. Pays off for names of 8 to 46 characters from a vocabulary "
+                     "that mostly fits. 0 disables it. The hit rate is reported at the end of the run."));
 #ifdef BUILD_EXTERNAL_PARSER
   VW::external::parser::set_parse_args(input_options, parsed_options);
 #endif
@@ -475,13 +505,24 @@ input_options parse_source(vw& all, options_i& options)
                          << endl;
   }
 
-  if (parsed_options.daemon || options.was_supplied("pid_file") || (options.was_supplied("port") && !all.active))
+  // Instances seeded from a daemon pass --no_daemon and must not get its pass count.
+  if (!all.no_daemon &&
+      (parsed_options.daemon || options.was_supplied("pid_file") || (options.was_supplied("port") && !all.active)))
   {
     all.daemon = true;
     // allow each child to process up to 1e5 connections
     all.numpasses = (size_t)1e5;
   }
 
+  if (parsed_options.parse_threads == 0) { THROW("parse_threads should be positive"); }
+  if (parsed_options.read_ahead_kb == 0) { THROW("read_ahead_kb should be positive"); }
+  if (parsed_options.compression != "gzip" && parsed_options.compression != "zstd")
+  { THROW("compression should be gzip or zstd"); }
+#ifndef BUILD_ZSTD
+  if (parsed_options.compression == "zstd")
+  { THROW("zstd compression is not supported, VW has to be built with BUILD_ZSTD"); }
+#endif
+
   // Add an implicit cache file based on the data filename.
   if (parsed_options.cache) { parsed_options.cache_files.push_back(all.data_filename + ".cache"); }
 
@@ -1441,6 +1482,8 @@ vw& parse_args(
                        "given, also used for initial weights."));
     all.options->add_and_parse(update_args);
 
+    std::string weight_hugepages;
+    std::string weight_numa;
     option_group_definition weight_args("Weight options");
     weight_args
         .add(make_option("initial_regressor", all.initial_regressors).help("Initial regressor(s)").short_name("i"))
@@ -1449,9 +1492,18 @@ vw& parse_args(
         .add(make_option("normal_weights", all.normal_weights).help("make initial weights normal"))
         .add(make_option("truncated_normal_weights", all.tnormal_weights).help("make initial weights truncated normal"))
         .add(make_option("sparse_weights", all.weights.sparse).help("Use a sparse datastructure for weights"))
+        .add(make_option("weight_hugepages", weight_hugepages)
+                 .help("Map dense weights on 2MB pages: transparent (madvise) or explicit (MAP_HUGETLB, needs pages "
+                       "reserved in /proc/sys/vm/nr_hugepages). Linux only."))
+        .add(make_option("weight_numa", weight_numa)
+                 .help("Place dense weights across NUMA nodes: interleave, or the id of a node to bind them to. Linux "
+                       "only."))
         .add(make_option("input_feature_regularizer", all.per_feature_regularizer_input)
                  .help("Per feature regularization input file"));
     all.options->add_and_parse(weight_args);
+    if (all.options->was_supplied("weight_hugepages"))
+    { VW::parse_hugepage_mode(weight_hugepages, all.weights.dense_allocation); }
+    if (all.options->was_supplied("weight_numa")) { VW::parse_numa_mode(weight_numa, all.weights.dense_allocation); }
 
     std::string span_server_arg;
     int span_server_port_arg;
@@ -1459,6 +1511,8 @@ vw& parse_args(
     size_t unique_id_arg;
     size_t total_arg;
     size_t node_arg;
+    std::string all_reduce_algorithm_arg;
+    std::string all_reduce_float_arg;
     option_group_definition parallelization_args("Parallelization options");
     parallelization_args
         .add(make_option("span_server", span_server_arg).help("Location of server for setting up spanning tree"))
@@ -1469,9 +1523,28 @@ vw& parse_args(
         .add(make_option("node", node_arg).default_value(0).help("node number in cluster parallel job"))
         .add(make_option("span_server_port", span_server_port_arg)
                  .default_value(26543)
-                 .help("Port of the server for setting up spanning tree"));
+                 .help("Port of the server for setting up spanning tree"))
+        .add(make_option("all_reduce_mode", all_reduce_algorithm_arg)
+                 .default_value("tree")
+                 .help("How nodes combine their models: tree reduces and broadcasts over the spanning tree, ring "
+                       "pipelines a reduce-scatter and allgather around a ring of all nodes. Every node must use the "
+                       "same algorithm."))
+        .add(make_option("all_reduce_sparse", all.all_reduce_sparse)
+                 .help("Only send the weights that are not zero on some node when averaging or summing models, "
+                       "with their indices delta encoded. Falls back to sending every weight for dense models."))
+        .add(make_option("all_reduce_float", all_reduce_float_arg)
+                 .default_value("fp32")
+                 .help("Precision of the weights sent when averaging or summing models: fp32, fp16 or bf16. The "
+                       "rounding error is kept, at the cost of a float and a row index per weight that has one, and "
+                       "sent with the next sync. Weights beyond the 16 bit range are clamped."))
+        .add(make_option("learner_threads", all.learner_threads)
+                 .default_value(1)
+                 .help("Number of threads learning from the examples without locking the shared weights. Only for "
+                       "gd, ftrl and oaa with dense weights."));
     all.options->add_and_parse(parallelization_args);
 
+    if (all.learner_threads == 0) { THROW("learner_threads should be positive"); }
+
     // total, unique_id and node must be specified together.
     if ((all.options->was_supplied("total") || all.options->was_supplied("node") ||
             all.options->was_supplied("unique_id")) &&
@@ -1479,11 +1552,28 @@ vw& parse_args(
             all.options->was_supplied("unique_id")))
     { THROW("you must specificy unique_id, total, and node if you specify any"); }
 
+    AllReduceAlgorithm all_reduce_algorithm = AllReduceAlgorithm::Tree;
+    if (all_reduce_algorithm_arg == "ring") { all_reduce_algorithm = AllReduceAlgorithm::Ring; }
+    else if (all_reduce_algorithm_arg != "tree")
+    {
+      THROW("all_reduce_mode must be tree or ring, got: " << all_reduce_algorithm_arg);
+    }
+
+    if (all_reduce_float_arg == "fp16") { all.all_reduce_precision = AllReducePrecision::Float16; }
+    else if (all_reduce_float_arg == "bf16")
+    {
+      all.all_reduce_precision = AllReducePrecision::BFloat16;
+    }
+    else if (all_reduce_float_arg != "fp32")
+    {
+      THROW("all_reduce_float must be fp32, fp16 or bf16, got: " << all_reduce_float_arg);
+    }
+
     if (all.options->was_supplied("span_server"))
     {
       all.all_reduce_type = AllReduceType::Socket;
-      all.all_reduce = new AllReduceSockets(
-          span_server_arg, span_server_port_arg, unique_id_arg, total_arg, node_arg, all.logger.quiet);
+      all.all_reduce = new AllReduceSockets(span_server_arg, span_server_port_arg, unique_id_arg, total_arg, node_arg,
+          all.logger.quiet, all_reduce_algorithm);
     }
 
     parse_diagnostics(*all.options.get(), all);
@@ -1654,6 +1744,8 @@ void parse_sources(options_i& options, vw& all, io_buf& model, bool skipModelLoa
     model.close_file();
 
   auto parsed_source_options = parse_source(all, options);
+  if (all.learner_threads > 1 && !all.no_daemon && (all.daemon || all.active))
+  { THROW("--learner_threads cannot be used in daemon or active learning mode"); }
   enable_sources(all, all.logger.quiet, all.numpasses, parsed_source_options);
 
   // force wpp to be a power of 2 to avoid 32-bit overflow
@@ -1889,6 +1981,12 @@ vw* initialize(
 // Create a new VW instance while sharing the model with another instance
 // The extra arguments will be appended to those of the other VW instance
 vw* seed_vw_model(vw* vw_model, const std::string extra_args, trace_message_t trace_listener, void* trace_context)
+{
+  return seed_vw_model(vw_model, extra_args, {}, trace_listener, trace_context);
+}
+
+vw* seed_vw_model(vw* vw_model, const std::string extra_args, const std::vector<std::string>& excluded_options,
+    trace_message_t trace_listener, void* trace_context)
 {
   options_serializer_boost_po serializer;
   for (auto const& option : vw_model->options->get_all_options())
@@ -1898,6 +1996,8 @@ vw* seed_vw_model(vw* vw_model, const std::string extra_args, trace_message_t tr
       // ignore no_stdin since it will be added by vw::initialize, and ignore -i since we don't want to reload the
       // model.
       if (option->m_name == "no_stdin" || option->m_name == "initial_regressor") { continue; }
+      if (std::find(excluded_options.begin(), excluded_options.end(), option->m_name) != excluded_options.end())
+      { continue; }
 
       serializer.add(*option);
     }
@@ -1987,6 +2087,20 @@ void finish(vw& all, bool delete_all)
 
     *(all.trace_message) << endl << "total feature number = " << all.sd->total_features;
     if (all.sd->queries > 0) *(all.trace_message) << endl << "total queries = " << all.sd->queries;
+    if (all.example_parser->report_storage_stats)
+    {
+      const auto& stats = all.example_parser->storage_stats;
+      *(all.trace_message) << endl
+                           << "example storage high water = " << stats.max_used << " bytes used, " << stats.max_retained
+                           << " bytes kept, released " << stats.released << " times";
+    }
+    if (all.example_parser->hash_cache != nullptr)
+    {
+      all.example_parser->hash_cache->flush_stats();
+      const auto& stats = all.example_parser->hash_cache_stats;
+      *(all.trace_message) << endl << "hash cache hits = " << stats.hits << " of " << stats.lookups << " lookups";
+      if (stats.lookups > 0) { *(all.trace_message) << " (" << 100. * stats.hits / stats.lookups << "%)"; }
+    }
     *(all.trace_message) << endl;
   }
 
@@ -13,6 +13,7 @@ struct input_options
   size_t port;
   std::string pid_file;
   std::string port_file;
+  size_t daemon_threads = 0;
 
   bool cache;
   std::vector<std::string> cache_files;
@@ -22,6 +23,13 @@ struct input_options
   bool compressed;
   bool chain_hash_json;
   bool flatbuffer = false;
+  size_t parse_threads = 1;
+  size_t cache_block_size = 0;
+  std::string compression;
+  size_t read_ahead = 0;
+  size_t read_ahead_kb = 1024;
+  bool example_storage_stats = false;
+  size_t hash_cache = 0;
 #ifdef BUILD_EXTERNAL_PARSER
   // pointer because it is an incomplete type
   std::unique_ptr<VW::external::parser_options> ext_opts;
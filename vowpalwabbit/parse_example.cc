@@ -2,6 +2,7 @@
 // individual contributors. All rights reserved. Released under a BSD (revised)
 // license as described in the file LICENSE.
 
+#include <algorithm>
 #include <cmath>
 #include <cctype>
 #include "parse_example.h"
@@ -102,6 +103,12 @@ public:
     }
   }
 
+  inline FORCE_INLINE uint64_t hash(VW::string_view token, uint64_t seed)
+  {
+    if (_p->hash_cache != nullptr) { return _p->hash_cache->hash(_p->hasher, token, seed); }
+    return _p->hasher(token.begin(), token.length(), seed);
+  }
+
   inline FORCE_INLINE VW::string_view stringFeatureValue(VW::string_view sv)
   {
     size_t start_idx = sv.find_first_not_of(" \t\r\n");
@@ -111,8 +118,7 @@ public:
       sv.remove_prefix(start_idx);
     }
 
-    size_t end_idx = sv.find_first_of(" \t\r\n");
-    if (end_idx == std::string::npos) { end_idx = sv.size(); }
+    size_t end_idx = VW::find_first_of<' ', '\t', '\r', '\n'>(sv, 0);
     _read_idx += end_idx;
     return sv.substr(0, end_idx);
   }
@@ -155,9 +161,7 @@ public:
   inline FORCE_INLINE VW::string_view read_name()
   {
     size_t name_start = _read_idx;
-    while (!(_read_idx >= _line.size() || _line[_read_idx] == ' ' || _line[_read_idx] == ':' ||
-        _line[_read_idx] == '\t' || _line[_read_idx] == '|' || _line[_read_idx] == '\r'))
-      ++_read_idx;
+    _read_idx = VW::find_first_of<' ', ':', '\t', '|', '\r'>(_line, _read_idx);
 
     return _line.substr(name_start, _read_idx - name_start);
   }
@@ -193,14 +197,12 @@ public:
       if (!string_feature_value.empty())
       {
         // chain hash is hash(feature_value, hash(feature_name, namespace_hash)) & parse_mask
-        word_hash = (_p->hasher(string_feature_value.begin(), string_feature_value.length(),
-                         _p->hasher(feature_name.begin(), feature_name.length(), _channel_hash)) &
-            _parse_mask);
+        word_hash = (hash(string_feature_value, hash(feature_name, _channel_hash)) & _parse_mask);
       }
       // Case where string:float
       else if (!feature_name.empty())
       {
-        word_hash = (_p->hasher(feature_name.begin(), feature_name.length(), _channel_hash) & _parse_mask);
+        word_hash = (hash(feature_name, _channel_hash) & _parse_mask);
       }
       // Case where :float
       else
@@ -379,7 +381,7 @@ public:
       if (_ae->feature_space[_index].size() == 0) _new_index = true;
       VW::string_view name = read_name();
       if (audit) { _base = name; }
-      _channel_hash = _p->hasher(name.begin(), name.length(), this->_hash_seed);
+      _channel_hash = hash(name, this->_hash_seed);
       nameSpaceInfoValue();
     }
   }
@@ -449,13 +451,13 @@ public:
     }
   }
 
-  TC_parser(VW::string_view line, vw& all, example* ae) : _line(line)
+  TC_parser(VW::string_view line, vw& all, parser* p, example* ae) : _line(line)
   {
     _spelling = v_init<char>();
     if (!_line.empty())
     {
       this->_read_idx = 0;
-      this->_p = all.example_parser;
+      this->_p = p;
       this->_redefine_some = all.redefine_some;
       this->_redefine = &all.redefine;
       this->_ae = ae;
@@ -473,15 +475,15 @@ public:
   }
 };
 
-void substring_to_example(vw* all, example* ae, VW::string_view example)
+void substring_to_example(vw* all, parser* p, example* ae, VW::string_view example)
 {
   if (example.empty()) { ae->is_newline = true; }
 
-  all->example_parser->lbl_parser.default_label(&ae->l);
+  p->lbl_parser.default_label(&ae->l);
 
   size_t bar_idx = example.find('|');
 
-  all->example_parser->words.clear();
+  p->words.clear();
   if (bar_idx != 0)
   {
     VW::string_view label_space(example);
@@ -494,31 +496,35 @@ void substring_to_example(vw* all, example* ae, VW::string_view example)
     size_t tab_idx = label_space.find('\t');
     if (tab_idx != VW::string_view::npos) { label_space.remove_prefix(tab_idx + 1); }
 
-    tokenize(' ', label_space, all->example_parser->words);
-    if (all->example_parser->words.size() > 0 &&
-        (all->example_parser->words.back().end() == label_space.end() ||
-            all->example_parser->words.back().front() == '\''))  // The last field is a tag, so record and strip it off
+    tokenize(' ', label_space, p->words);
+    if (p->words.size() > 0 &&
+        (p->words.back().end() == label_space.end() ||
+            p->words.back().front() == '\''))  // The last field is a tag, so record and strip it off
     {
-      VW::string_view tag = all->example_parser->words.back();
-      all->example_parser->words.pop_back();
+      VW::string_view tag = p->words.back();
+      p->words.pop_back();
       if (tag.front() == '\'') { tag.remove_prefix(1); }
       ae->tag.insert(ae->tag.end(), tag.begin(), tag.end());
     }
   }
 
-  if (!all->example_parser->words.empty())
-    all->example_parser->lbl_parser.parse_label(all->example_parser, all->example_parser->_shared_data, &ae->l,
-        all->example_parser->words, ae->_reduction_features);
+  if (!p->words.empty())
+    p->lbl_parser.parse_label(p, p->_shared_data, &ae->l, p->words, ae->_reduction_features);
 
   if (bar_idx != VW::string_view::npos)
   {
     if (all->audit || all->hash_inv)
-      TC_parser<true> parser_line(example.substr(bar_idx), *all, ae);
+      TC_parser<true> parser_line(example.substr(bar_idx), *all, p, ae);
     else
-      TC_parser<false> parser_line(example.substr(bar_idx), *all, ae);
+      TC_parser<false> parser_line(example.substr(bar_idx), *all, p, ae);
   }
 }
 
+void substring_to_example(vw* all, example* ae, VW::string_view example)
+{
+  substring_to_example(all, all->example_parser, ae, example);
+}
+
 namespace VW
 {
 void read_line(vw& all, example* ex, VW::string_view line)
@@ -529,6 +535,53 @@ void read_line(vw& all, example* ex, VW::string_view line)
 
 void read_line(vw& all, example* ex, char* line) { return read_line(all, ex, VW::string_view(line)); }
 
+namespace
+{
+class text_input_format : public parallel_parser::input_format
+{
+public:
+  explicit text_input_format(size_t lines_per_chunk) : _lines_per_chunk(std::max<size_t>(lines_per_chunk, 1)) {}
+
+  void read_chunk(vw& all, parallel_parser::chunk& c) override
+  {
+    while (c.consumed.size() < _lines_per_chunk)
+    {
+      char* line;
+      size_t num_chars;
+      size_t num_chars_initial = read_features(&all, line, num_chars);
+      if (num_chars_initial < 1) { break; }
+
+      // The io_buf may shift or reallocate on the next read, so the line has to be copied out. The number parsers
+      // may look one character past the end of the line, terminate it like it would be in the io_buf.
+      c.offsets.push_back(c.data.size());
+      c.lengths.push_back(num_chars);
+      c.consumed.push_back(num_chars_initial);
+      c.data.insert(c.data.end(), line, line + num_chars);
+      c.data.push_back('\n');
+    }
+  }
+
+  void parse_chunk(vw& all, parallel_parser::chunk& c, parser& scratch) override
+  {
+    for (; c.num_parsed < c.examples.size(); c.num_parsed++)
+    {
+      // Only used to report the example number in parse warnings.
+      scratch.end_parsed_examples = c.first_example_index + c.num_parsed;
+      VW::string_view line(c.data.data() + c.offsets[c.num_parsed], c.lengths[c.num_parsed]);
+      substring_to_example(&all, &scratch, c.examples[c.num_parsed], line);
+    }
+  }
+
+private:
+  size_t _lines_per_chunk;
+};
+}  // namespace
+
+std::unique_ptr<parallel_parser::input_format> make_text_input_format(size_t lines_per_chunk)
+{
+  return VW::make_unique<text_input_format>(lines_per_chunk);
+}
+
 void read_lines(vw* all, const char* line, size_t /*len*/, v_array<example*>& examples)
 {
   std::vector<VW::string_view> lines;
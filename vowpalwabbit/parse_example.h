@@ -15,6 +15,8 @@ typedef enum
 } FeatureInputType;
 
 void substring_to_example(vw* all, example* ae, VW::string_view example);
+// Parses using the scratch state (words, label parser, hasher) of the given parser instead of all->example_parser.
+void substring_to_example(vw* all, parser* p, example* ae, VW::string_view example);
 
 namespace VW
 {
@@ -23,6 +25,9 @@ void read_line(vw& all, example* ex, char* line);  // read example from the line
 void read_lines(vw* all, const char* line, size_t len,
     v_array<example*>& examples);  // read examples from the new line separated strings.
 
+// Cuts newline delimited text input into chunks of lines_per_chunk lines for parallel_parser.
+std::unique_ptr<parallel_parser::input_format> make_text_input_format(size_t lines_per_chunk = 64);
+
 }  // namespace VW
 
 int read_features_string(vw* all, v_array<example*>& examples);
@@ -772,7 +772,7 @@ struct IgnoreState : BaseState<audit>
 };
 
 template <bool audit>
-class DefaultState : public BaseState<audit>
+class DefaultState final : public BaseState<audit>
 {
 public:
   DefaultState() : BaseState<audit>("Default") {}
@@ -1325,7 +1325,7 @@ public:
 };
 
 template <bool audit>
-class DecisionServiceState : public BaseState<audit>
+class DecisionServiceState final : public BaseState<audit>
 {
 public:
   DecisionServiceState() : BaseState<audit>("DecisionService") {}
@@ -1574,23 +1574,56 @@ struct VWReaderHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
     ctx.dedup_examples = dedup_examples;
   }
 
-  // virtual dispatch to current state
-  bool Bool(bool v) { return ctx.TransitionState(ctx.current_state->Bool(ctx, v)); }
-  bool Int(int v) { return ctx.TransitionState(ctx.current_state->Float(ctx, (float)v)); }
-  bool Uint(unsigned v) { return ctx.TransitionState(ctx.current_state->Uint(ctx, v)); }
-  bool Int64(int64_t v) { return ctx.TransitionState(ctx.current_state->Float(ctx, (float)v)); }
-  bool Uint64(uint64_t v) { return ctx.TransitionState(ctx.current_state->Float(ctx, (float)v)); }
-  bool Double(double v) { return ctx.TransitionState(ctx.current_state->Float(ctx, (float)v)); }
+  // Features make up most of the tokens of an example and are all handled by the default state. Its handlers are
+  // called directly, which lets them be inlined, as are those of the decision service state for the keys and objects
+  // at the top of a DSJSON event. Every other state goes through virtual dispatch.
+  bool in_default_state() const { return ctx.current_state == &ctx.default_state; }
+  bool in_decision_service_state() const { return ctx.current_state == &ctx.decision_service_state; }
+
+  BaseState<audit>* dispatch_float(float v)
+  {
+    if (in_default_state()) { return ctx.default_state.Float(ctx, v); }
+    return ctx.current_state->Float(ctx, v);
+  }
+
+  bool Bool(bool v)
+  {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.Bool(ctx, v)); }
+    return ctx.TransitionState(ctx.current_state->Bool(ctx, v));
+  }
+  bool Int(int v) { return ctx.TransitionState(dispatch_float((float)v)); }
+  bool Uint(unsigned v)
+  {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.Uint(ctx, v)); }
+    return ctx.TransitionState(ctx.current_state->Uint(ctx, v));
+  }
+  bool Int64(int64_t v) { return ctx.TransitionState(dispatch_float((float)v)); }
+  bool Uint64(uint64_t v) { return ctx.TransitionState(dispatch_float((float)v)); }
+  bool Double(double v) { return ctx.TransitionState(dispatch_float((float)v)); }
   bool String(const char* str, SizeType len, bool copy)
   {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.String(ctx, str, len, copy)); }
     return ctx.TransitionState(ctx.current_state->String(ctx, str, len, copy));
   }
-  bool StartObject() { return ctx.TransitionState(ctx.current_state->StartObject(ctx)); }
+  bool StartObject()
+  {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.StartObject(ctx)); }
+    if (in_decision_service_state()) { return ctx.TransitionState(ctx.decision_service_state.StartObject(ctx)); }
+    return ctx.TransitionState(ctx.current_state->StartObject(ctx));
+  }
   bool Key(const char* str, SizeType len, bool copy)
   {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.Key(ctx, str, len, copy)); }
+    if (in_decision_service_state())
+    { return ctx.TransitionState(ctx.decision_service_state.Key(ctx, str, len, copy)); }
     return ctx.TransitionState(ctx.current_state->Key(ctx, str, len, copy));
   }
-  bool EndObject(SizeType count) { return ctx.TransitionState(ctx.current_state->EndObject(ctx, count)); }
+  bool EndObject(SizeType count)
+  {
+    if (in_default_state()) { return ctx.TransitionState(ctx.default_state.EndObject(ctx, count)); }
+    if (in_decision_service_state()) { return ctx.TransitionState(ctx.decision_service_state.EndObject(ctx, count)); }
+    return ctx.TransitionState(ctx.current_state->EndObject(ctx, count));
+  }
   bool StartArray() { return ctx.TransitionState(ctx.current_state->StartArray(ctx)); }
   bool EndArray(SizeType count) { return ctx.TransitionState(ctx.current_state->EndArray(ctx, count)); }
   bool Null() { return ctx.TransitionState(ctx.current_state->Null(ctx)); }
@@ -18,6 +18,14 @@
 
 #include "io/logger.h"
 
+#if !defined(VW_NO_INLINE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#  define VW_SSE2_SCAN
+#  include <emmintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#endif
+
 // chop up the string into a v_array or any compatible container of VW::string_view.
 template <typename ContainerT>
 void tokenize(char delim, VW::string_view s, ContainerT& ret, bool allow_empty = false)
@@ -38,6 +46,68 @@ void tokenize(char delim, VW::string_view s, ContainerT& ret, bool allow_empty =
 // This function returns a vector of strings (not string_views) because we need to remove the escape characters
 std::vector<std::string> escaped_tokenize(char delim, VW::string_view s, bool allow_empty = false);
 
+namespace VW
+{
+namespace details
+{
+template <char D>
+inline bool is_any_of(char c)
+{
+  return c == D;
+}
+
+template <char D, char D2, char... Rest>
+inline bool is_any_of(char c)
+{
+  return c == D || is_any_of<D2, Rest...>(c);
+}
+
+#ifdef VW_SSE2_SCAN
+template <char D>
+inline __m128i match_any_of(__m128i block)
+{
+  return _mm_cmpeq_epi8(block, _mm_set1_epi8(D));
+}
+
+template <char D, char D2, char... Rest>
+inline __m128i match_any_of(__m128i block)
+{
+  return _mm_or_si128(match_any_of<D>(block), match_any_of<D2, Rest...>(block));
+}
+
+inline int lowest_set_bit(int mask)
+{
+#  ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, static_cast<unsigned long>(mask));
+  return static_cast<int>(index);
+#  else
+  return __builtin_ctz(static_cast<unsigned int>(mask));
+#  endif
+}
+#endif
+}  // namespace details
+
+// Index of the first character of s at or after pos that is one of Delims, or s.size() if there is none. Compares 16
+// characters at a time where SSE2 is available. It never reads past the end of s.
+template <char... Delims>
+inline FORCE_INLINE size_t find_first_of(VW::string_view s, size_t pos)
+{
+  const char* data = s.begin();
+  const size_t size = s.size();
+#ifdef VW_SSE2_SCAN
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    const int mask = _mm_movemask_epi8(details::match_any_of<Delims...>(block));
+    if (mask != 0) { return pos + details::lowest_set_bit(mask); }
+  }
+#endif
+  while (pos < size && !details::is_any_of<Delims...>(data[pos])) { ++pos; }
+  return pos;
+}
+}  // namespace VW
+
 inline const char* safe_index(const char* start, char v, const char* max)
 {
   while (start != max && *start != v) start++;
@@ -57,6 +57,16 @@ double calculate_sd(vw& /* all */, T& weights)
   double sq_sum = inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
   return std::sqrt(sq_sum / my_size);
 }
+void construct_weights(vw& /* all */, sparse_parameters& weights, size_t length, uint32_t stride_shift)
+{
+  new (&weights) sparse_parameters(length, stride_shift);
+}
+
+void construct_weights(vw& all, dense_parameters& weights, size_t length, uint32_t stride_shift)
+{
+  new (&weights) dense_parameters(length, stride_shift, all.weights.dense_allocation);
+}
+
 template <class T>
 void initialize_regressor(vw& all, T& weights)
 {
@@ -68,11 +78,12 @@ void initialize_regressor(vw& all, T& weights)
   {
     uint32_t ss = weights.stride_shift();
     weights.~T();  // dealloc so that we can realloc, now with a known size
-    new (&weights) T(length, ss);
+    construct_weights(all, weights, length, ss);
   }
-  catch (const VW::vw_exception&)
+  catch (const VW::vw_exception& e)
   {
-    THROW(" Failed to allocate weight array with " << all.num_bits << " bits: try decreasing -b <bits>");
+    THROW(" Failed to allocate weight array with " << all.num_bits << " bits: try decreasing -b <bits>. "
+                                                   << e.what());
   }
   if (weights.mask() == 0)
   { THROW(" Failed to allocate weight array with " << all.num_bits << " bits: try decreasing -b <bits>"); }
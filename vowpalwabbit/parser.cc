@@ -92,7 +92,7 @@ bool is_test_only(uint32_t counter, uint32_t period, uint32_t after, bool holdou
 
 void set_compressed(parser* /*par*/) {}
 
-uint32_t cache_numbits(io_buf* buf, VW::io::reader* filepointer)
+uint32_t cache_numbits(io_buf* buf, VW::io::reader* filepointer, bool& block_format)
 {
   size_t v_length;
   buf->read_file(filepointer, (char*)&v_length, sizeof(v_length));
@@ -111,7 +111,8 @@ uint32_t cache_numbits(io_buf* buf, VW::io::reader* filepointer)
   char temp;
   if (buf->read_file(filepointer, &temp, 1) < 1) THROW("failed to read");
 
-  if (temp != 'c') THROW("data file is not a cache file");
+  if (temp != stream_cache_marker && temp != block_cache_marker) THROW("data file is not a cache file");
+  block_format = temp == block_cache_marker;
 
   uint32_t cache_numbits;
   if (buf->read_file(filepointer, &cache_numbits, sizeof(cache_numbits)) < (int)sizeof(cache_numbits)) { return true; }
@@ -119,7 +120,33 @@ uint32_t cache_numbits(io_buf* buf, VW::io::reader* filepointer)
   return cache_numbits;
 }
 
-void set_cache_reader(vw& all) { all.example_parser->reader = read_cached_features; }
+std::unique_ptr<VW::io::reader> with_read_ahead(const parser& p, std::unique_ptr<VW::io::reader> input)
+{
+  if (p.read_ahead == 0) { return input; }
+  return VW::io::create_read_ahead_reader(std::move(input), p.read_ahead_buffer_size, p.read_ahead);
+}
+
+std::unique_ptr<VW::io::reader> open_cache_file_reader(const parser& p, const std::string& file)
+{
+  // Reading a mapped file stalls on page faults just like on reads, so read-ahead replaces the mapping.
+  if (p.read_ahead > 0) { return with_read_ahead(p, VW::io::open_file_reader(file)); }
+  return VW::io::open_mapped_file_reader(file);
+}
+
+void set_cache_reader(vw& all, bool block_format)
+{
+  if (block_format)
+  {
+    all.example_parser->parallel_reader = VW::make_unique<VW::parallel_parser>(
+        all, VW::make_cache_block_input_format(), all.example_parser->parse_threads);
+    all.example_parser->reader = read_features_parallel;
+  }
+  else
+  {
+    all.example_parser->parallel_reader.reset();
+    all.example_parser->reader = read_cached_features;
+  }
+}
 
 void set_string_reader(vw& all)
 {
@@ -188,9 +215,18 @@ void reset_source(vw& all, size_t numbits)
   io_buf* input = all.example_parser->input.get();
   input->current = 0;
 
+  // Examples parsed ahead of the reset belong to the previous pass.
+  if (all.example_parser->parallel_reader != nullptr) { all.example_parser->parallel_reader->reset(); }
+
   // If in write cache mode then close all of the input files then open the written cache as the new input.
   if (all.example_parser->write_cache)
   {
+    const bool block_format = all.example_parser->cache_block_writer != nullptr;
+    if (block_format)
+    {
+      all.example_parser->cache_block_writer->flush(*all.example_parser->output);
+      all.example_parser->cache_block_writer.reset();
+    }
     all.example_parser->output->flush();
     // Turn off write_cache as we are now reading it instead of writing!
     all.example_parser->write_cache = false;
@@ -205,8 +241,8 @@ void reset_source(vw& all, size_t numbits)
                                                                           << all.example_parser->finalname);
     input->close_files();
     // Now open the written cache as the new input file.
-    input->add_file(VW::io::open_file_reader(all.example_parser->finalname));
-    set_cache_reader(all);
+    input->add_file(open_cache_file_reader(*all.example_parser, all.example_parser->finalname));
+    set_cache_reader(all, block_format);
   }
 
   if (all.example_parser->resettable == true)
@@ -247,7 +283,8 @@ void reset_source(vw& all, size_t numbits)
       for (auto& file : input->get_input_files())
       {
         input->reset_file(file.get());
-        if (cache_numbits(input, file.get()) < numbits) THROW("argh, a bug in caching of some sort!");
+        bool block_format;
+        if (cache_numbits(input, file.get(), block_format) < numbits) THROW("argh, a bug in caching of some sort!");
       }
     }
   }
@@ -255,7 +292,7 @@ void reset_source(vw& all, size_t numbits)
 
 void finalize_source(parser*) {}
 
-void make_write_cache(vw& all, std::string& newname, bool quiet)
+void make_write_cache(vw& all, const std::string& newname, const input_options& options, bool quiet)
 {
   io_buf* output = all.example_parser->output.get();
   if (output->num_files() != 0)
@@ -279,25 +316,39 @@ void make_write_cache(vw& all, std::string& newname, bool quiet)
 
   output->bin_write_fixed(reinterpret_cast<const char*>(&v_length), sizeof(v_length));
   output->bin_write_fixed(VW::version.to_string().c_str(), v_length);
-  output->bin_write_fixed("c", 1);
+  const bool block_format = options.cache_block_size > 0;
+  output->bin_write_fixed(block_format ? &block_cache_marker : &stream_cache_marker, 1);
   output->bin_write_fixed(reinterpret_cast<const char*>(&all.num_bits), sizeof(all.num_bits));
   output->flush();
+  if (block_format)
+  {
+    auto compression = VW::cache_block_compression::none;
+    if (options.compressed)
+    {
+      compression =
+          options.compression == "zstd" ? VW::cache_block_compression::zstd : VW::cache_block_compression::zlib;
+    }
+    all.example_parser->cache_block_writer =
+        VW::make_unique<VW::cache_block_writer>(options.cache_block_size, compression);
+  }
 
   all.example_parser->finalname = newname;
   all.example_parser->write_cache = true;
   if (!quiet) *(all.trace_message) << "creating cache_file = " << newname << endl;
 }
 
-void parse_cache(vw& all, std::vector<std::string> cache_files, bool kill_cache, bool quiet)
+void parse_cache(vw& all, const input_options& options, bool quiet)
 {
   all.example_parser->write_cache = false;
+  bool reading_block_format = false;
+  bool reading_stream_format = false;
 
-  for (auto& file : cache_files)
+  for (auto& file : options.cache_files)
   {
     bool cache_file_opened = false;
-    if (!kill_cache) try
+    if (!options.kill_cache) try
       {
-        all.example_parser->input->add_file(VW::io::open_file_reader(file));
+        all.example_parser->input->add_file(open_cache_file_reader(*all.example_parser, file));
         cache_file_opened = true;
       }
       catch (const std::exception&)
@@ -305,23 +356,27 @@ void parse_cache(vw& all, std::vector<std::string> cache_files, bool kill_cache,
         cache_file_opened = false;
       }
     if (cache_file_opened == false)
-      make_write_cache(all, file, quiet);
+      make_write_cache(all, file, options, quiet);
     else
     {
-      uint64_t c =
-          cache_numbits(all.example_parser->input.get(), all.example_parser->input->get_input_files().back().get());
+      bool block_format;
+      uint64_t c = cache_numbits(
+          all.example_parser->input.get(), all.example_parser->input->get_input_files().back().get(), block_format);
       if (c < all.num_bits)
       {
         if (!quiet)
           *(all.trace_message) << "WARNING: cache file is ignored as it's made with less bit precision than required!"
                                << endl;
         all.example_parser->input->close_file();
-        make_write_cache(all, file, quiet);
+        make_write_cache(all, file, options, quiet);
       }
       else
       {
         if (!quiet) *(all.trace_message) << "using cache_file = " << file.c_str() << endl;
-        set_cache_reader(all);
+        (block_format ? reading_block_format : reading_stream_format) = true;
+        if (reading_block_format && reading_stream_format)
+        { THROW("cache files in block and stream format can't be mixed"); }
+        set_cache_reader(all, block_format);
         if (c == all.num_bits)
           all.example_parser->sorted_cache = true;
         else
@@ -332,7 +387,7 @@ void parse_cache(vw& all, std::vector<std::string> cache_files, bool kill_cache,
   }
 
   all.parse_mask = ((uint64_t)1 << all.num_bits) - 1;
-  if (cache_files.size() == 0)
+  if (options.cache_files.size() == 0)
   {
     if (!quiet) *(all.trace_message) << "using no cache" << endl;
   }
@@ -346,7 +401,17 @@ void parse_cache(vw& all, std::vector<std::string> cache_files, bool kill_cache,
 void enable_sources(vw& all, bool quiet, size_t passes, input_options& input_options)
 {
   all.example_parser->input->current = 0;
-  parse_cache(all, input_options.cache_files, input_options.kill_cache, quiet);
+  all.example_parser->parse_threads = input_options.parse_threads;
+  all.example_parser->read_ahead = input_options.read_ahead;
+  all.example_parser->read_ahead_buffer_size = input_options.read_ahead_kb * 1024;
+  all.example_parser->report_storage_stats = input_options.example_storage_stats;
+  all.example_parser->hash_cache_size = input_options.hash_cache;
+  if (input_options.hash_cache > 0)
+  {
+    all.example_parser->hash_cache =
+        VW::make_unique<VW::hash_cache>(input_options.hash_cache, all.example_parser->hash_cache_stats);
+  }
+  parse_cache(all, input_options, quiet);
 
   // default text reader
   all.example_parser->text_reader = VW::read_lines;
@@ -387,7 +452,8 @@ void enable_sources(vw& all, bool quiet, size_t passes, input_options& input_opt
     if (::bind(all.example_parser->bound_sock, (sockaddr*)&address, sizeof(address)) < 0) THROWERRNO("bind");
 
     // listen on socket
-    if (listen(all.example_parser->bound_sock, 1) < 0) THROWERRNO("listen");
+    const bool serve_in_process = all.daemon && !all.active && input_options.daemon_threads > 0;
+    if (listen(all.example_parser->bound_sock, serve_in_process ? SOMAXCONN : 1) < 0) THROWERRNO("listen");
 
     // write port file
     if (all.options->was_supplied("port_file"))
@@ -431,6 +497,22 @@ void enable_sources(vw& all, bool quiet, size_t passes, input_options& input_opt
 #endif
     }
 
+    if (serve_in_process)
+    {
+      // Connections are accepted by the server once the driver would start.
+      fclose(stdin);
+      if (input_options.json || input_options.dsjson) { set_json_reader(all, input_options.dsjson); }
+      else
+      {
+        set_string_reader(all);
+      }
+      all.chain_hash_json = input_options.chain_hash_json;
+      all.example_parser->daemon_server.reset(
+          new VW::daemon_server(all, all.example_parser->bound_sock, input_options.daemon_threads));
+      all.example_parser->resettable = false;
+      return;
+    }
+
     if (all.daemon && !all.active)
     {
 #ifdef _WIN32
@@ -540,25 +622,23 @@ void enable_sources(vw& all, bool quiet, size_t passes, input_options& input_opt
       std::string temp = all.data_filename;
       if (!quiet) *(all.trace_message) << "Reading datafile = " << temp << endl;
 
-      auto should_use_compressed = input_options.compressed || ends_with(all.data_filename, ".gz");
+      auto should_use_compressed = input_options.compressed || ends_with(all.data_filename, ".gz") ||
+          ends_with(all.data_filename, ".zst");
 
       try
       {
         std::unique_ptr<VW::io::reader> adapter;
-        if (temp != "")
-        {
-          adapter = should_use_compressed ? VW::io::open_compressed_file_reader(temp) : VW::io::open_file_reader(temp);
-        }
+        if (temp != "") { adapter = with_read_ahead(*all.example_parser, VW::io::open_file_reader(temp)); }
         else if (!all.stdin_off)
         {
           // Should try and use stdin
-          if (should_use_compressed) { adapter = VW::io::open_compressed_stdin(); }
-          else
-          {
-            adapter = VW::io::open_stdin();
-          }
+          adapter = VW::io::open_stdin();
         }
 
+        // Decompress on background threads so that the parser does not have to.
+        if (adapter && should_use_compressed)
+        { adapter = VW::io::create_decompressing_reader(std::move(adapter), input_options.parse_threads); }
+
         if (adapter) { all.example_parser->input->add_file(std::move(adapter)); }
       }
       catch (std::exception const&)
@@ -600,6 +680,13 @@ void enable_sources(vw& all, bool quiet, size_t passes, input_options& input_opt
       else
       {
         set_string_reader(all);
+        if (input_options.parse_threads > 1)
+        {
+          all.example_parser->parallel_reader = VW::make_unique<VW::parallel_parser>(
+              all, VW::make_text_input_format(), input_options.parse_threads);
+          all.example_parser->reader = read_features_parallel;
+          if (!quiet) *(all.trace_message) << "parse threads = " << input_options.parse_threads << endl;
+        }
       }
 
       all.example_parser->resettable = all.example_parser->write_cache;
@@ -644,6 +731,18 @@ void feature_limit(vw& all, example* ex)
     }
 }
 
+namespace
+{
+// Pooled examples which keep more storage than this between uses free it.
+constexpr size_t max_retained_example_bytes = 4 << 20;
+
+void update_high_water(std::atomic<size_t>& high_water, size_t value)
+{
+  size_t current = high_water.load(std::memory_order_relaxed);
+  while (value > current && !high_water.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+}  // namespace
+
 namespace VW
 {
 example& get_unused_example(vw* all)
@@ -669,8 +768,13 @@ void setup_example(vw& all, example* ae)
 
   if (all.example_parser->write_cache)
   {
-    all.example_parser->lbl_parser.cache_label(&ae->l, ae->_reduction_features, *(all.example_parser->output));
-    cache_features(*(all.example_parser->output), ae, all.parse_mask);
+    if (all.example_parser->cache_block_writer != nullptr)
+    { all.example_parser->cache_block_writer->write(all, ae, *(all.example_parser->output)); }
+    else
+    {
+      all.example_parser->lbl_parser.cache_label(&ae->l, ae->_reduction_features, *(all.example_parser->output));
+      cache_features(*(all.example_parser->output), ae, all.parse_mask);
+    }
   }
 
   ae->partial_prediction = 0.;
@@ -856,12 +960,38 @@ void parse_example_label(vw& all, example& ec, std::string label)
       all.example_parser, all.example_parser->_shared_data, &ec.l, words, ec._reduction_features);
 }
 
-void empty_example(vw& /*all*/, example& ec)
+void empty_example(vw& all, example& ec)
 {
-  for (features& fs : ec) fs.clear();
+  // Everything is cleared in place so that the next example parsed into ec reuses its storage instead of allocating.
+  size_t used = ec.indices.size() + ec.tag.size();
+  size_t retained = ec.indices.capacity() + ec.tag.capacity();
+  for (features& fs : ec)
+  {
+    used += fs.values.size() * sizeof(feature_value) + fs.indicies.size() * sizeof(feature_index) +
+        fs.space_names.size() * sizeof(audit_strings_ptr);
+    retained += fs.values.capacity() * sizeof(feature_value) + fs.indicies.capacity() * sizeof(feature_index) +
+        fs.space_names.capacity() * sizeof(audit_strings_ptr);
+    fs.clear_noshrink();
+  }
+  ec.tag.clear_noshrink();
 
-  ec.indices.clear();
-  ec.tag.clear();
+  auto& stats = all.example_parser->storage_stats;
+  update_high_water(stats.max_used, used);
+  update_high_water(stats.max_retained, retained);
+  if (retained > max_retained_example_bytes)
+  {
+    // Do not let an outlier pin its memory in the pool.
+    for (features& fs : ec)
+    {
+      fs.values.shrink_to_fit();
+      fs.indicies.shrink_to_fit();
+      fs.space_names.shrink_to_fit();
+    }
+    ec.tag.shrink_to_fit();
+    stats.released++;
+  }
+
+  ec.indices.clear_noshrink();
   ec.sorted = false;
   ec.end_pass = false;
   ec.is_newline = false;
@@ -969,6 +1099,9 @@ void start_parser(vw& all) { all.parse_thread = std::thread(main_parse_loop, &al
 
 void free_parser(vw& all)
 {
+  // Stop the parse workers and give back any examples they parsed ahead.
+  all.example_parser->parallel_reader.reset();
+
   // It is possible to exit early when the queue is not yet empty.
 
   while (all.example_parser->ready_parsed_examples.size() > 0)
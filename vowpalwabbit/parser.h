@@ -26,10 +26,24 @@
 #include "queue.h"
 #include "object_pool.h"
 #include "hashstring.h"
+#include "hash_cache.h"
 #include "simple_label_parser.h"
+#include "parallel_parser.h"
+#include "cache.h"
+#include "daemon_server.h"
 
 struct vw;
 struct input_options;
+
+// Pooled examples keep the storage of their features, indices and tag between uses, see VW::empty_example. These are
+// the high water marks of that storage, in bytes.
+struct example_storage_stats
+{
+  std::atomic<size_t> max_used{0};      // most storage filled by a single example
+  std::atomic<size_t> max_retained{0};  // most storage kept by a single example when it was returned to the pool
+  std::atomic<size_t> released{0};      // number of times an example kept too much storage and had to free it
+};
+
 struct parser
 {
   parser(size_t ring_size, bool strict_parse_)
@@ -54,19 +68,34 @@ struct parser
   std::vector<VW::string_view> words;
 
   VW::object_pool<example> example_pool;
-  VW::ptr_queue<example> ready_parsed_examples;
+  VW::spsc_ptr_queue<example> ready_parsed_examples;
 
   std::unique_ptr<io_buf> input;  // Input source(s)
   /// reader consumes the input io_buf in the vw object and is generally for file based parsing
   int (*reader)(vw*, v_array<example*>& examples);
   /// text_reader consumes the char* input and is for text based parsing
   void (*text_reader)(vw*, const char*, size_t, v_array<example*>&);
+  /// parses text input on a pool of threads when --parse_threads is greater than 1, and block format caches
+  std::unique_ptr<VW::parallel_parser> parallel_reader;
+  size_t parse_threads = 1;
+  /// number of buffers input files are read ahead of the parser, 0 if they are read synchronously
+  size_t read_ahead = 0;
+  size_t read_ahead_buffer_size = 0;
 
   shared_data* _shared_data = nullptr;
 
+  example_storage_stats storage_stats;
+  bool report_storage_stats = false;
+
   hash_func_t hasher;
+  /// set with --hash_cache, each scratch parser of parallel_reader gets its own of hash_cache_size entries
+  std::unique_ptr<VW::hash_cache> hash_cache;
+  size_t hash_cache_size = 0;
+  VW::hash_cache_stats hash_cache_stats;
   bool resettable;           // Whether or not the input can be reset.
   std::unique_ptr<io_buf> output;  // Where to output the cache.
+  /// set while writing a block format cache
+  std::unique_ptr<VW::cache_block_writer> cache_block_writer;
   std::string currentname;
   std::string finalname;
 
@@ -91,6 +120,8 @@ struct parser
   v_array<size_t> counts;  // partial examples received from sources
   size_t finished_count;   // the number of finished examples;
   int bound_sock = 0;
+  /// serves the daemon connections when --daemon_threads is set, run instead of the driver
+  std::unique_ptr<VW::daemon_server> daemon_server;
 
   std::vector<VW::string_view> parse_name;
 
@@ -119,3 +150,9 @@ void finalize_source(parser* source);
 VW_DEPRECATED("Function is no longer used")
 void set_compressed(parser* par);
 void free_parser(vw& all);
+
+namespace VW
+{
+// Empties the example and returns it to the example pool.
+void clean_example(vw& all, example& ec, bool rewind);
+}  // namespace VW
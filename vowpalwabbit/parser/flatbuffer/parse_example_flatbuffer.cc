@@ -178,8 +178,12 @@ void parser::parse_namespaces(vw* all, example* ae, const Namespace* ns)
 
   auto& fs = ae->feature_space[temp_index];
 
-  for (const auto& feature : *(ns->features()))
-  { parse_features(all, fs, feature, (all->audit || all->hash_inv) ? ns->name() : nullptr); }
+  if (flatbuffers::IsFieldPresent(ns, Namespace::VT_FEATURES))
+  {
+    for (const auto& feature : *(ns->features()))
+    { parse_features(all, fs, feature, (all->audit || all->hash_inv) ? ns->name() : nullptr); }
+  }
+  if (flatbuffers::IsFieldPresent(ns, Namespace::VT_FEATURE_HASHES)) { parse_packed_features(fs, ns); }
 }
 
 void parser::parse_features(vw* all, features& fs, const Feature* feature, const flatbuffers::String* ns)
@@ -197,6 +201,24 @@ void parser::parse_features(vw* all, features& fs, const Feature* feature, const
   }
 }
 
+void parser::parse_packed_features(features& fs, const Namespace* ns)
+{
+  const auto* hashes = ns->feature_hashes();
+  if (!flatbuffers::IsFieldPresent(ns, Namespace::VT_FEATURE_VALUES))
+  {
+    for (const auto hash : *hashes) { fs.push_back(1.f, hash); }
+    return;
+  }
+
+  const auto* values = ns->feature_values();
+  if (values->size() != hashes->size())
+  {
+    THROW("Namespace has " << hashes->size() << " feature_hashes but " << values->size() << " feature_values");
+  }
+  // Scalars are stored little endian, so the vectors are copied as they are.
+  fs.push_back(values->data(), hashes->data(), hashes->size());
+}
+
 void parser::parse_flat_label(shared_data* sd, example* ae, const Example* eg)
 {
   switch (eg->label_type())
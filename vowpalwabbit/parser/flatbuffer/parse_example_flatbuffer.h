@@ -43,6 +43,7 @@ private:
   void parse_multi_example(vw* all, example* ae, const MultiExample* eg);
   void parse_namespaces(vw* all, example* ae, const Namespace* ns);
   void parse_features(vw* all, features& fs, const Feature* feature, const flatbuffers::String* ns);
+  void parse_packed_features(features& fs, const Namespace* ns);
   void parse_flat_label(shared_data* sd, example* ae, const Example* eg);
 
   void parse_simple_label(shared_data* sd, polylabel* l, reduction_features* red_features, const SimpleLabel* label);
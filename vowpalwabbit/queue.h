@@ -4,7 +4,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <queue>
+#include <thread>
+#include <vector>
+
+#if !defined(VW_NO_INLINE_SIMD)
+#  if !defined(__SSE2__) && (defined(_M_AMD64) || defined(_M_X64))
+#    define __SSE2__
+#  endif
+
+#  if defined(__SSE2__)
+#    include <xmmintrin.h>
+#  endif
+#endif
 
 // Mutex and CV cannot be used in managed C++, tell the compiler that this is unmanaged even if included in a managed
 // project.
@@ -77,4 +92,158 @@ private:
   std::condition_variable is_not_full;
   std::condition_variable is_not_empty;
 };
+
+namespace details
+{
+inline void cpu_relax()
+{
+#if !defined(VW_NO_INLINE_SIMD) && defined(__SSE2__)
+  _mm_pause();
+#endif
+}
+
+// Spin, then yield, then block on a condition variable until ready() holds. The spin budget adapts to how often
+// spinning alone was enough, so a busy pipeline never touches the mutex and an idle one stops burning a core.
+struct adaptive_waiter
+{
+  // Copied before being passed by reference, so that C++11 needs no definition of them outside the class.
+  static constexpr size_t MIN_SPINS = 16;
+  static constexpr size_t MAX_SPINS = 4096;
+  static constexpr size_t YIELDS = 16;
+
+  std::atomic<bool> parked{false};
+  std::condition_variable cv;
+  // Spinning cannot help when the other side needs this core to make progress.
+  size_t spin_limit = std::thread::hardware_concurrency() > 1 ? MAX_SPINS : 0;
+
+  template <typename TPredicate>
+  void wait(std::mutex& mut, TPredicate ready)
+  {
+    for (size_t i = 0; i < spin_limit; i++)
+    {
+      if (ready())
+      {
+        spin_limit = std::min(spin_limit * 2, size_t{MAX_SPINS});
+        return;
+      }
+      cpu_relax();
+    }
+    if (spin_limit > 0) { spin_limit = std::max(spin_limit / 2, size_t{MIN_SPINS}); }
+
+    for (size_t i = 0; i < YIELDS; i++)
+    {
+      if (ready()) { return; }
+      std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(mut);
+    // Both the flag and the state checked by ready() are sequentially consistent, so either the other side sees the
+    // flag and notifies, or ready() sees its update.
+    parked = true;
+    cv.wait(lock, ready);
+    parked = false;
+  }
+
+  void wake(std::mutex& mut)
+  {
+    if (parked)
+    {
+      std::lock_guard<std::mutex> lock(mut);
+      cv.notify_one();
+    }
+  }
+};
+}  // namespace details
+
+// Bounded single producer, single consumer queue with the same interface as ptr_queue. push and pop only touch the
+// mutex when the other side has gone to sleep.
+template <typename T>
+class spsc_ptr_queue
+{
+public:
+  spsc_ptr_queue(size_t max_size) : _max_size(max_size)
+  {
+    size_t capacity = 1;
+    while (capacity < max_size) { capacity <<= 1; }
+    _buffer.resize(capacity, nullptr);
+    _mask = capacity - 1;
+  }
+
+  spsc_ptr_queue(const spsc_ptr_queue&) = delete;
+  spsc_ptr_queue& operator=(const spsc_ptr_queue&) = delete;
+
+  T* pop()
+  {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _cached_tail)
+    {
+      _consumer.wait(_mut, [&] {
+        _cached_tail = _tail.load();
+        return head != _cached_tail || _done.load();
+      });
+      // The producer pushes everything before calling set_done, so reload to drain what is left.
+      _cached_tail = _tail.load();
+      if (head == _cached_tail) { return nullptr; }
+    }
+
+    T* item = _buffer[head & _mask];
+    _head.store(head + 1);
+    _producer.wake(_mut);
+    return item;
+  }
+
+  void push(T* item)
+  {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _cached_head == _max_size)
+    {
+      _producer.wait(_mut, [&] {
+        _cached_head = _head.load();
+        return tail - _cached_head < _max_size;
+      });
+    }
+
+    _buffer[tail & _mask] = item;
+    _tail.store(tail + 1);
+    _consumer.wake(_mut);
+  }
+
+  void set_done()
+  {
+    _done = true;
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      _consumer.cv.notify_all();
+      _producer.cv.notify_all();
+    }
+  }
+
+  size_t size() const
+  {
+    const size_t head = _head.load();
+    return _tail.load() - head;
+  }
+
+private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  std::vector<T*> _buffer;
+  size_t _mask;
+  const size_t _max_size;
+  std::atomic<bool> _done{false};
+  std::mutex _mut;
+
+  // Consumer owned. Padding keeps the two sides from sharing a cache line.
+  char _pad0[CACHE_LINE_SIZE];
+  std::atomic<size_t> _head{0};
+  size_t _cached_tail = 0;
+  details::adaptive_waiter _consumer;
+
+  // Producer owned.
+  char _pad1[CACHE_LINE_SIZE];
+  std::atomic<size_t> _tail{0};
+  size_t _cached_head = 0;
+  details::adaptive_waiter _producer;
+  char _pad2[CACHE_LINE_SIZE];
+};
 }  // namespace VW
@@ -5,6 +5,7 @@
 #pragma once
 #include "ccb_reduction_features.h"
 #include "continuous_actions_reduction_features.h"
+#include "shared_feature_merger_reduction_features.h"
 #include "simple_label.h"
 
 /*
@@ -33,6 +34,7 @@ private:
   CCB::reduction_features _ccb_reduction_features;
   VW::continuous_actions::reduction_features _contact_reduction_features;
   simple_label_reduction_features _simple_label_reduction_features;
+  VW::shared_feature_merger::reduction_features _sfm_reduction_features;
 
 public:
   template <typename T>
@@ -46,6 +48,7 @@ public:
     _ccb_reduction_features.clear();
     _contact_reduction_features.clear();
     _simple_label_reduction_features.reset_to_default();
+    _sfm_reduction_features.clear();
   }
 };
 
@@ -85,3 +88,17 @@ inline const simple_label_reduction_features& reduction_features::get<simple_lab
 {
   return _simple_label_reduction_features;
 }
+
+template <>
+inline VW::shared_feature_merger::reduction_features&
+reduction_features::get<VW::shared_feature_merger::reduction_features>()
+{
+  return _sfm_reduction_features;
+}
+
+template <>
+inline const VW::shared_feature_merger::reduction_features&
+reduction_features::get<VW::shared_feature_merger::reduction_features>() const
+{
+  return _sfm_reduction_features;
+}
@@ -12,8 +12,12 @@
 #include "vw.h"
 #include "scope_exit.h"
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 
+using namespace VW::config;
+
 namespace VW
 {
 namespace shared_feature_merger
@@ -30,33 +34,178 @@ bool use_reduction(config::options_i& options)
   return false;
 }
 
+// Reductions which are known to only use the actions through predict when predicting. Factorizing the shared features
+// is only safe when every reduction below this one is in this list.
+static const std::vector<std::string> factorizable_reductions = {"gd", "scorer", "csoaa_ldf", "cb_adf",
+    "cb_explore_adf_greedy", "cb_explore_adf_softmax", "cb_explore_adf_first", "cb_explore_adf_bag",
+    "cb_explore_adf_cover", "cb_sample", "explore_eval"};
+
 struct sfm_data
 {
+  bool factorize_shared = false;
+
+  // State of a factorized prediction, see begin_factorized.
+  shared_context context;
+  std::array<bool, NUM_NAMESPACES> in_actions{};
+  std::array<bool, NUM_NAMESPACES> shared_only{};
+  std::array<bool, NUM_NAMESPACES> crossed{};
+  namespace_interactions shared_interactions;
+  namespace_interactions action_interactions;
+  namespace_interactions* interactions = nullptr;
+  std::vector<namespace_index> merged;
+  std::vector<namespace_index> shared_indices;
+  uint64_t shared_offset = 0;
+  float shared_initial = 0.f;
 };
 
+// Splits the interactions in those made only of shared_only namespaces, which are scored once on the shared example,
+// and the others, which are scored on each action. The shared_only namespaces the others use are marked as crossed.
+void split_interactions(sfm_data& data, const namespace_interactions& interactions)
+{
+  data.shared_interactions.interactions.clear();
+  data.action_interactions.interactions.clear();
+  data.crossed.fill(false);
+  for (const auto& interaction : interactions.interactions)
+  {
+    if (std::all_of(interaction.begin(), interaction.end(), [&data](namespace_index ns) { return data.shared_only[ns]; }))
+    {
+      data.shared_interactions.interactions.push_back(interaction);
+      continue;
+    }
+
+    data.action_interactions.interactions.push_back(interaction);
+    for (namespace_index ns : interaction)
+    {
+      if (data.shared_only[ns]) { data.crossed[ns] = true; }
+    }
+  }
+}
+
+// Merges into the actions only the shared namespaces that they also have or that are crossed with their own, and
+// leaves the rest of the shared features for GD to score once through the shared context. Returns false, with nothing
+// changed, when there is nothing to leave out.
+bool begin_factorized(sfm_data& data, example& shared, multi_ex& actions)
+{
+  data.interactions = actions[0]->interactions;
+  for (auto* action : actions)
+  {
+    if (action->interactions != data.interactions) { return false; }
+  }
+
+  data.in_actions.fill(false);
+  for (auto* action : actions)
+  {
+    for (namespace_index ns : action->indices) { data.in_actions[ns] = true; }
+  }
+
+  data.shared_only.fill(false);
+  bool any_shared_only = false;
+  for (namespace_index ns : shared.indices)
+  {
+    if (ns != constant_namespace && !data.in_actions[ns])
+    {
+      data.shared_only[ns] = true;
+      any_shared_only = true;
+    }
+  }
+  if (!any_shared_only) { return false; }
+
+  split_interactions(data, *data.interactions);
+
+  // The shared example keeps only the namespaces that are scored through the shared context.
+  data.shared_indices.assign(shared.indices.begin(), shared.indices.end());
+  data.merged.clear();
+  shared.indices.clear();
+  for (namespace_index ns : data.shared_indices)
+  {
+    if (ns == constant_namespace) { continue; }
+    if (data.shared_only[ns] && !data.crossed[ns]) { shared.indices.push_back(ns); }
+    else
+    {
+      data.merged.push_back(ns);
+    }
+  }
+
+  for (auto* action : actions)
+  {
+    for (namespace_index ns : data.merged) { LabelDict::add_example_namespace(*action, ns, shared.feature_space[ns]); }
+    // Count the features left out too, like when all the shared features are merged.
+    for (namespace_index ns : shared.indices)
+    {
+      action->num_features += shared.feature_space[ns].size();
+      action->total_sum_feat_sq += shared.feature_space[ns].sum_feat_sq;
+    }
+    action->interactions = &data.action_interactions;
+    action->_reduction_features.template get<reduction_features>().context = &data.context;
+  }
+
+  auto& simple_red_features = shared._reduction_features.template get<simple_label_reduction_features>();
+  data.shared_initial = simple_red_features.initial;
+  simple_red_features.initial = 0.f;
+  data.shared_offset = shared.ft_offset;
+  shared.interactions = &data.shared_interactions;
+  data.context.shared = &shared;
+  data.context.scores.clear();
+  return true;
+}
+
+void end_factorized(sfm_data& data, example& shared, multi_ex& actions)
+{
+  for (auto* action : actions)
+  {
+    action->_reduction_features.template get<reduction_features>().context = nullptr;
+    action->interactions = data.interactions;
+    for (namespace_index ns : shared.indices)
+    {
+      action->num_features -= shared.feature_space[ns].size();
+      action->total_sum_feat_sq -= shared.feature_space[ns].sum_feat_sq;
+    }
+    for (auto ns = data.merged.rbegin(); ns != data.merged.rend(); ++ns)
+    { LabelDict::del_example_namespace(*action, *ns, shared.feature_space[*ns]); }
+  }
+
+  shared.indices.clear();
+  for (namespace_index ns : data.shared_indices) { shared.indices.push_back(ns); }
+  shared.interactions = data.interactions;
+  shared.ft_offset = data.shared_offset;
+  shared._reduction_features.template get<simple_label_reduction_features>().initial = data.shared_initial;
+  data.context.shared = nullptr;
+}
+
 template <bool is_learn>
-void predict_or_learn(sfm_data&, VW::LEARNER::multi_learner& base, multi_ex& ec_seq)
+void predict_or_learn(sfm_data& data, VW::LEARNER::multi_learner& base, multi_ex& ec_seq)
 {
   if (ec_seq.size() == 0) THROW("cb_adf: At least one action must be provided for an example to be valid.");
 
   multi_ex::value_type shared_example = nullptr;
 
   const bool has_example_header = CB::ec_is_example_header(*ec_seq[0]);
+  bool factorized = false;
   if (has_example_header)
   {
     shared_example = ec_seq[0];
     ec_seq.erase(ec_seq.begin());
     // merge sequences
-    for (auto& example : ec_seq) LabelDict::add_example_namespaces_from_example(*example, *shared_example);
+    // Learning updates the weights of all the features of an action, so they are only factorized when predicting.
+    if (!is_learn && data.factorize_shared && !ec_seq.empty())
+    { factorized = begin_factorized(data, *shared_example, ec_seq); }
+    if (!factorized)
+    {
+      for (auto& example : ec_seq) LabelDict::add_example_namespaces_from_example(*example, *shared_example);
+    }
     std::swap(ec_seq[0]->pred, shared_example->pred);
     std::swap(ec_seq[0]->tag, shared_example->tag);
   }
 
   // Guard example state restore against throws
-  auto restore_guard = VW::scope_exit([has_example_header, &shared_example, &ec_seq] {
+  auto restore_guard = VW::scope_exit([&data, factorized, has_example_header, &shared_example, &ec_seq] {
     if (has_example_header)
     {
-      for (auto& example : ec_seq) LabelDict::del_example_namespaces_from_example(*example, *shared_example);
+      if (factorized) { end_factorized(data, *shared_example, ec_seq); }
+      else
+      {
+        for (auto& example : ec_seq) LabelDict::del_example_namespaces_from_example(*example, *shared_example);
+      }
       std::swap(shared_example->pred, ec_seq[0]->pred);
       std::swap(shared_example->tag, ec_seq[0]->tag);
       ec_seq.insert(ec_seq.begin(), shared_example);
@@ -72,12 +221,36 @@ void predict_or_learn(sfm_data&, VW::LEARNER::multi_learner& base, multi_ex& ec_
 
 VW::LEARNER::base_learner* shared_feature_merger_setup(config::options_i& options, vw& all)
 {
-  if (!use_reduction(options)) return nullptr;
+  bool factorize_shared = false;
+  option_group_definition new_options("Shared feature merger");
+  new_options.add(make_option("factorize_shared", factorize_shared)
+                      .help("When predicting, score shared-only namespaces once per multiline example instead of once "
+                            "per action"));
+  options.add_and_parse(new_options);
+
+  if (!use_reduction(options))
+  {
+    if (factorize_shared) { THROW("--factorize_shared requires a multiline reduction such as --cb_adf"); }
+    return nullptr;
+  }
 
   auto data = scoped_calloc_or_throw<sfm_data>();
+  data->factorize_shared = factorize_shared;
 
   auto* base = VW::LEARNER::as_multiline(setup_base(options, all));
 
+  if (factorize_shared)
+  {
+    // The shared context is scored by gd and the rest of the stack must not look at the features of the actions.
+    for (const auto& reduction : all.enabled_reductions)
+    {
+      if (std::find(factorizable_reductions.begin(), factorizable_reductions.end(), reduction) ==
+          factorizable_reductions.end())
+      { THROW("--factorize_shared cannot be used with " << reduction); }
+    }
+    if (all.audit || all.hash_inv) { THROW("--factorize_shared cannot be used with --audit or --invert_hash"); }
+  }
+
   auto& learner = VW::LEARNER::init_learner(data, base, predict_or_learn<true>, predict_or_learn<false>,
       all.get_setupfn_name(shared_feature_merger_setup), base->learn_returns_prediction);
 
@@ -0,0 +1,33 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct example;
+
+namespace VW
+{
+namespace shared_feature_merger
+{
+// The shared features of a multiline example that are scored once for all its actions, see --factorize_shared.
+struct shared_context
+{
+  // The shared example, limited to the namespaces and interactions which involve no action features.
+  example* shared = nullptr;
+  // Its score for each ft_offset the actions were predicted at, some reductions predict with several models.
+  std::vector<std::pair<uint64_t, float>> scores;
+};
+
+struct reduction_features
+{
+  // Set on the actions while they are predicted with the shared context left out of them.
+  shared_context* context = nullptr;
+  void clear() { context = nullptr; }
+};
+}  // namespace shared_feature_merger
+}  // namespace VW
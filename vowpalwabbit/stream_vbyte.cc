@@ -0,0 +1,152 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "stream_vbyte.h"
+
+#include <cstring>
+
+// The SIMD decoder is compiled for SSSE3 regardless of the target flags and only selected when the CPU reports
+// support at runtime.
+#if !defined(VW_NO_INLINE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#  define VW_STREAM_VBYTE_SSSE3
+#  include <tmmintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define VW_TARGET_SSSE3
+#  else
+#    define VW_TARGET_SSSE3 __attribute__((target("ssse3")))
+#  endif
+#endif
+
+namespace VW
+{
+namespace stream_vbyte
+{
+namespace
+{
+inline uint8_t encoded_length(uint32_t value)
+{
+  if (value < (1U << 8)) { return 1; }
+  if (value < (1U << 16)) { return 2; }
+  if (value < (1U << 24)) { return 3; }
+  return 4;
+}
+
+inline size_t decode_scalar_from(const uint8_t* control, const uint8_t* data, size_t first, size_t count, uint32_t* out)
+{
+  const uint8_t* p = data;
+  for (size_t i = first; i < count; i++)
+  {
+    const size_t length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+    uint32_t value = 0;
+    for (size_t b = 0; b < length; b++) { value |= static_cast<uint32_t>(p[b]) << (8 * b); }
+    out[i] = value;
+    p += length;
+  }
+  return p - data;
+}
+
+#if defined(VW_STREAM_VBYTE_SSSE3)
+struct shuffle_tables
+{
+  // For every control byte, the shuffle which expands the next 4 encoded values to 4 little endian uint32_t and the
+  // number of data bytes they take.
+  alignas(16) uint8_t shuffle[256][16];
+  uint8_t length[256];
+
+  shuffle_tables()
+  {
+    for (size_t c = 0; c < 256; c++)
+    {
+      uint8_t src = 0;
+      for (size_t v = 0; v < 4; v++)
+      {
+        const size_t value_length = ((c >> (2 * v)) & 3) + 1;
+        for (size_t b = 0; b < 4; b++)
+        { shuffle[c][4 * v + b] = b < value_length ? src++ : 0xff; }  // 0xff makes pshufb write a zero byte
+      }
+      length[c] = src;
+    }
+  }
+};
+
+const shuffle_tables& get_shuffle_tables()
+{
+  static const shuffle_tables tables;
+  return tables;
+}
+
+bool cpu_has_ssse3()
+{
+#  if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 9)) != 0;
+#  else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3") != 0;
+#  endif
+}
+
+VW_TARGET_SSSE3 size_t decode_ssse3(
+    const uint8_t* control, const uint8_t* data, size_t data_size, size_t count, uint32_t* out)
+{
+  const shuffle_tables& tables = get_shuffle_tables();
+  const uint8_t* p = data;
+  const uint8_t* const end = data + data_size;
+  size_t i = 0;
+  // Every iteration loads 16 bytes, stop where that could read past the end and let the scalar loop finish.
+  for (; i + 4 <= count && p + 16 <= end; i += 4)
+  {
+    const uint8_t c = control[i / 4];
+    const __m128i encoded = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.shuffle[c]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(encoded, shuffle));
+    p += tables.length[c];
+  }
+  return (p - data) + decode_scalar_from(control, p, i, count, out);
+}
+#endif
+}  // namespace
+
+size_t encode(const uint32_t* in, size_t count, uint8_t* control, uint8_t* data)
+{
+  std::memset(control, 0, control_bytes(count));
+  uint8_t* p = data;
+  for (size_t i = 0; i < count; i++)
+  {
+    const uint32_t value = in[i];
+    const uint8_t length = encoded_length(value);
+    control[i / 4] |= static_cast<uint8_t>((length - 1) << (2 * (i % 4)));
+    for (size_t b = 0; b < length; b++) { *p++ = static_cast<uint8_t>(value >> (8 * b)); }
+  }
+  return p - data;
+}
+
+size_t decode_scalar(const uint8_t* control, const uint8_t* data, size_t count, uint32_t* out)
+{
+  return decode_scalar_from(control, data, 0, count, out);
+}
+
+bool simd_available()
+{
+#if defined(VW_STREAM_VBYTE_SSSE3)
+  static const bool available = cpu_has_ssse3();
+  return available;
+#else
+  return false;
+#endif
+}
+
+size_t decode(const uint8_t* control, const uint8_t* data, size_t data_size, size_t count, uint32_t* out)
+{
+#if defined(VW_STREAM_VBYTE_SSSE3)
+  if (simd_available()) { return decode_ssse3(control, data, data_size, count, out); }
+#else
+  (void)data_size;
+#endif
+  return decode_scalar(control, data, count, out);
+}
+}  // namespace stream_vbyte
+}  // namespace VW
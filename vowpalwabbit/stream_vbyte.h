@@ -0,0 +1,36 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VW
+{
+/*
+ * Stream VByte stores every 32 bit value in 1 to 4 bytes like a varint, but keeps the byte lengths in a separate
+ * control stream of 2 bits per value instead of a continuation bit in every byte. A decoder can then expand four
+ * values at once with a single byte shuffle looked up from the control byte, without any data dependent branches.
+ */
+namespace stream_vbyte
+{
+inline size_t control_bytes(size_t count) { return (count + 3) / 4; }
+inline size_t max_data_bytes(size_t count) { return 4 * count; }
+
+// Encodes count values. control must have room for control_bytes(count) and data for max_data_bytes(count) bytes.
+// Returns the number of data bytes written.
+size_t encode(const uint32_t* in, size_t count, uint8_t* control, uint8_t* data);
+
+// Decodes count values, using SIMD when the CPU supports it. data_size bounds how far the decoder may read and must
+// cover at least the encoded values. Returns the number of data bytes consumed.
+size_t decode(const uint8_t* control, const uint8_t* data, size_t data_size, size_t count, uint32_t* out);
+
+// Portable decoder, always available.
+size_t decode_scalar(const uint8_t* control, const uint8_t* data, size_t count, uint32_t* out);
+
+// True if decode uses the SIMD decoder on this machine.
+bool simd_available();
+}  // namespace stream_vbyte
+}  // namespace VW
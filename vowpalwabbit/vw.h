@@ -53,6 +53,9 @@ vw* initialize(int argc, char* argv[], io_buf* model = nullptr, bool skipModelLo
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
 vw* seed_vw_model(
     vw* vw_model, std::string extra_args, trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
+// Same as above, but the options named in excluded_options are not passed on to the new instance.
+vw* seed_vw_model(vw* vw_model, std::string extra_args, const std::vector<std::string>& excluded_options,
+    trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
 // Allows the input command line string to have spaces escaped by '\'
 vw* initialize_escaped(std::string const& s, io_buf* model = nullptr, bool skipModelLoad = false,
     trace_message_t trace_listener = nullptr, void* trace_context = nullptr);
@@ -0,0 +1,163 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "weight_allocation.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+// sys/mman.h goes before memory.h, which only marks the heap table mergeable when MADV_MERGEABLE is defined.
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#elif !defined(_WIN32)
+#  include <sys/mman.h>
+#endif
+
+#include "memory.h"
+#include "vw_exception.h"
+#include "io/logger.h"
+
+namespace logger = VW::io::logger;
+
+namespace VW
+{
+namespace
+{
+#if defined(__linux__)
+// Size of the pages handed out by MAP_HUGETLB and by transparent hugepages on x86-64 and most aarch64 kernels.
+constexpr size_t hugepage_size = size_t(1) << 21;
+
+// Policies of mbind(2), defined here so that libnuma is not needed.
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+constexpr unsigned long mpol_f_mems_allowed = 1 << 2;
+constexpr unsigned long max_numa_nodes = 1024;
+constexpr size_t mask_words = max_numa_nodes / (8 * sizeof(unsigned long));
+
+void apply_numa_policy(void* data, size_t length, const weight_allocation& allocation)
+{
+  unsigned long nodes[mask_words] = {};
+  int mode;
+  if (allocation.numa == numa_mode::interleave)
+  {
+    // Interleave over the nodes this process may allocate from.
+    if (syscall(SYS_get_mempolicy, nullptr, nodes, max_numa_nodes, nullptr, mpol_f_mems_allowed) != 0)
+    { THROWERRNO("get_mempolicy failed for --weight_numa interleave"); }
+    mode = mpol_interleave;
+  }
+  else
+  {
+    const auto node = static_cast<size_t>(allocation.numa_node);
+    if (node >= max_numa_nodes) { THROW("--weight_numa node " << node << " is out of range"); }
+    nodes[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    mode = mpol_bind;
+  }
+  // The mapping is not touched yet, so every page is placed by the policy when it is first written.
+  if (syscall(SYS_mbind, data, length, mode, nodes, max_numa_nodes, 0) != 0)
+  { THROWERRNO("mbind failed for --weight_numa"); }
+}
+
+float* map_weights(size_t count, const weight_allocation& allocation, size_t& mapped_bytes)
+{
+  size_t length = count * sizeof(float);
+  if (allocation.hugepages != hugepage_mode::off) { length = (length + hugepage_size - 1) & ~(hugepage_size - 1); }
+
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (allocation.hugepages == hugepage_mode::explicit_pages) { flags |= MAP_HUGETLB; }
+  void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (data == MAP_FAILED)
+  {
+    if (allocation.hugepages == hugepage_mode::explicit_pages)
+    {
+      THROWERRNO("Failed to map " << length << " bytes of weights on explicit hugepages, reserve "
+                                  << length / hugepage_size << " pages in /proc/sys/vm/nr_hugepages");
+    }
+    THROWERRNO("Failed to map " << length << " bytes of weights");
+  }
+
+  if (allocation.hugepages == hugepage_mode::transparent && madvise(data, length, MADV_HUGEPAGE) != 0)
+  {
+    // Happens when transparent hugepages are disabled, the table still works on normal pages.
+    logger::log_warn("madvise(MADV_HUGEPAGE) failed for the weights ({}), using normal pages", strerror(errno));
+  }
+
+  if (allocation.numa != numa_mode::off)
+  {
+    try
+    {
+      apply_numa_policy(data, length, allocation);
+    }
+    catch (...)
+    {
+      munmap(data, length);
+      throw;
+    }
+  }
+
+  // Anonymous mappings are already zeroed.
+  mapped_bytes = length;
+  return static_cast<float*>(data);
+}
+#endif
+}  // namespace
+
+void parse_hugepage_mode(const std::string& value, weight_allocation& allocation)
+{
+  if (value == "transparent") { allocation.hugepages = hugepage_mode::transparent; }
+  else if (value == "explicit")
+  {
+    allocation.hugepages = hugepage_mode::explicit_pages;
+  }
+  else
+  {
+    THROW("--weight_hugepages must be transparent or explicit, got: " << value);
+  }
+}
+
+void parse_numa_mode(const std::string& value, weight_allocation& allocation)
+{
+  if (value == "interleave")
+  {
+    allocation.numa = numa_mode::interleave;
+    return;
+  }
+
+  char* end = nullptr;
+  const long node = std::strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || node < 0)
+  { THROW("--weight_numa must be interleave or a NUMA node id, got: " << value); }
+  allocation.numa = numa_mode::bind;
+  allocation.numa_node = static_cast<int>(node);
+}
+
+float* allocate_weights(size_t count, const weight_allocation& allocation, size_t& mapped_bytes)
+{
+  mapped_bytes = 0;
+  if (allocation.hugepages == hugepage_mode::off && allocation.numa == numa_mode::off)
+  { return calloc_mergable_or_throw<float>(count); }
+  if (count == 0) { return nullptr; }
+#if defined(__linux__)
+  return map_weights(count, allocation, mapped_bytes);
+#else
+  THROW("--weight_hugepages and --weight_numa are only supported on Linux");
+#endif
+}
+
+void free_weights(float* weights, size_t mapped_bytes)
+{
+#ifndef _WIN32
+  if (mapped_bytes != 0)
+  {
+    munmap(weights, mapped_bytes);
+    return;
+  }
+#else
+  _UNUSED(mapped_bytes);
+#endif
+  free(weights);
+}
+}  // namespace VW
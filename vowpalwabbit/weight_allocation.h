@@ -0,0 +1,49 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Placement of dense weight tables. By default the table comes from calloc_mergable_or_throw on normal pages. Large
+ * tables are accessed at random hashed offsets, so a table of several GB on 4KB pages misses the TLB on almost every
+ * access. The table can instead be mapped on 2MB pages, either transparent (madvise) or explicit (MAP_HUGETLB, which
+ * needs pages reserved in /proc/sys/vm/nr_hugepages), and spread over the NUMA nodes or bound to one of them. Only
+ * supported on Linux.
+ */
+namespace VW
+{
+enum class hugepage_mode
+{
+  off,
+  transparent,
+  explicit_pages
+};
+
+enum class numa_mode
+{
+  off,
+  interleave,
+  bind
+};
+
+struct weight_allocation
+{
+  hugepage_mode hugepages = hugepage_mode::off;
+  numa_mode numa = numa_mode::off;
+  int numa_node = 0;
+};
+
+// Parses the arguments of --weight_hugepages (transparent, explicit) and --weight_numa (interleave or a node id).
+void parse_hugepage_mode(const std::string& value, weight_allocation& allocation);
+void parse_numa_mode(const std::string& value, weight_allocation& allocation);
+
+// Zeroed table of count floats placed as requested. mapped_bytes is set to the length of the mapping, or to 0 if the
+// table was allocated on the heap. Throws if the mapping or the NUMA policy cannot be applied.
+float* allocate_weights(size_t count, const weight_allocation& allocation, size_t& mapped_bytes);
+// Releases a table from allocate_weights, or from mmap if mapped_bytes is not 0.
+void free_weights(float* weights, size_t mapped_bytes);
+}  // namespace VW
@@ -0,0 +1,94 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#include "worker_pool.h"
+
+#include <algorithm>
+
+namespace VW
+{
+worker_pool::worker_pool(size_t num_threads) : _num_threads(std::max<size_t>(num_threads, 1))
+{
+  for (size_t thread = 1; thread < _num_threads; thread++)
+  { _workers.emplace_back(&worker_pool::worker_loop, this, thread); }
+}
+
+worker_pool::~worker_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mut);
+    _shutdown = true;
+  }
+  _work_available.notify_all();
+  for (auto& worker : _workers) { worker.join(); }
+}
+
+void worker_pool::for_each(size_t count, const task_fn& task)
+{
+  if (_workers.empty() || count < 2)
+  {
+    for (size_t i = 0; i < count; i++) { task(i, 0); }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mut);
+    _task = &task;
+    _count = count;
+    _next.store(0);
+    _exc = nullptr;
+    _busy_workers = _workers.size();
+    _generation++;
+  }
+  _work_available.notify_all();
+
+  run_tasks(0);
+
+  std::exception_ptr exc;
+  {
+    std::unique_lock<std::mutex> lock(_mut);
+    _work_done.wait(lock, [this] { return _busy_workers == 0; });
+    _task = nullptr;
+    std::swap(exc, _exc);
+  }
+  if (exc) { std::rethrow_exception(exc); }
+}
+
+void worker_pool::run_tasks(size_t thread)
+{
+  for (size_t i = _next.fetch_add(1); i < _count; i = _next.fetch_add(1))
+  {
+    try
+    {
+      (*_task)(i, thread);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(_mut);
+      if (!_exc) { _exc = std::current_exception(); }
+      // Nothing is handed out after a failure.
+      _next.store(_count);
+    }
+  }
+}
+
+void worker_pool::worker_loop(size_t thread)
+{
+  uint64_t seen_generation = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(_mut);
+      _work_available.wait(lock, [this, seen_generation] { return _shutdown || _generation != seen_generation; });
+      if (_shutdown) { return; }
+      seen_generation = _generation;
+    }
+
+    run_tasks(thread);
+
+    std::lock_guard<std::mutex> lock(_mut);
+    if (--_busy_workers == 0) { _work_done.notify_one(); }
+  }
+}
+}  // namespace VW
@@ -0,0 +1,77 @@
+// Copyright (c) by respective owners including Yahoo!, Microsoft, and
+// individual contributors. All rights reserved. Released under a BSD (revised)
+// license as described in the file LICENSE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <vector>
+
+// Mutex, CV and thread cannot be used in managed C++, tell the compiler that this is unmanaged even if included in a
+// managed project.
+#ifdef _M_CEE
+#  pragma managed(push, off)
+#  undef _M_CEE
+#  include <mutex>
+#  include <condition_variable>
+#  include <thread>
+#  define _M_CEE 001
+#  pragma managed(pop)
+#else
+#  include <mutex>
+#  include <condition_variable>
+#  include <thread>
+#endif
+
+namespace VW
+{
+/**
+ * A fixed set of threads to run the iterations of a loop on, for work that is split up within a single call such as
+ * scoring the actions of one multiline example.
+ *
+ * The thread calling for_each runs iterations too, so a pool of num_threads only starts num_threads - 1 workers and a
+ * pool of one runs everything on the caller. Iterations are handed out one at a time in increasing order.
+ */
+class worker_pool
+{
+public:
+  // Called with the iteration and the index in [0, num_threads) of the thread running it, 0 being the caller.
+  using task_fn = std::function<void(size_t, size_t)>;
+
+  explicit worker_pool(size_t num_threads);
+  ~worker_pool();
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  // Runs task for every iteration in [0, count) and returns once all have finished. If tasks throw, the remaining
+  // iterations are skipped and the first exception is rethrown. Not reentrant.
+  void for_each(size_t count, const task_fn& task);
+
+  size_t num_threads() const { return _num_threads; }
+
+private:
+  void worker_loop(size_t thread);
+  void run_tasks(size_t thread);
+
+  size_t _num_threads;
+  std::vector<std::thread> _workers;
+
+  std::mutex _mut;
+  std::condition_variable _work_available;
+  std::condition_variable _work_done;
+  uint64_t _generation = 0;
+  size_t _busy_workers = 0;
+  bool _shutdown = false;
+
+  // The loop being run, set before _generation changes.
+  const task_fn* _task = nullptr;
+  size_t _count = 0;
+  std::atomic<size_t> _next{0};
+  std::exception_ptr _exc;
+};
+}  // namespace VW